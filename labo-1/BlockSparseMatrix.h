@@ -0,0 +1,284 @@
+#pragma once
+
+/**
+ * @file BlockSparseMatrix.h
+ *
+ * @brief Matrice creuse composée de blocs 2x2 (format BSR).
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "Expressions.h"
+#include "GTIAssert.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+namespace gti320
+{
+	/**
+	 * Matrice carrée creuse stockée par blocs 2x2 (Block Sparse Row).
+	 *
+	 * La structure (position des blocs non nuls) est construite une seule fois
+	 * avec `setPattern`. Par la suite, seules les valeurs des blocs sont
+	 * modifiées, ce qui évite toute allocation lors de l'assemblage.
+	 *
+	 * Les blocs d'une même ligne de blocs sont triés par colonne et le bloc
+	 * diagonal est toujours présent dans la structure. Les valeurs d'un bloc sont
+	 * stockées par lignes : (0, 0), (0, 1), (1, 0), (1, 1).
+	 */
+	template <typename Scalar = double>
+	class BlockSparseMatrix
+	{
+	public:
+		static constexpr int BlockSize = 2;
+		static constexpr int BlockLength = BlockSize * BlockSize;
+
+	private:
+		int m_blockRows; // Nombre de lignes (et de colonnes) de blocs
+
+		std::vector<int> m_rowPointers; // Indice du premier bloc de chaque ligne de blocs (taille : m_blockRows + 1)
+		std::vector<int> m_colIndices; // Colonne de bloc de chacun des blocs
+		std::vector<int> m_diagonalIndices; // Indice du bloc diagonal de chaque ligne de blocs
+		std::vector<Scalar> m_values; // Valeurs des blocs (BlockLength valeurs par bloc)
+
+	public:
+		/**
+		 * Constructeur par défaut
+		 */
+		BlockSparseMatrix() : m_blockRows(0), m_rowPointers(1, 0), m_colIndices(), m_diagonalIndices(), m_values()
+		{
+		}
+
+		/**
+		 * Constructeur à partir d'une expression (voir Expressions.h)
+		 */
+		template <typename Expression>
+		BlockSparseMatrix(const BlockSparseExpression<Expression>& expression) : BlockSparseMatrix()
+		{
+			*this = expression;
+		}
+
+		/**
+		 * Évalue une expression (par exemple `M - s * K`) dans la matrice.
+		 *
+		 * La structure n'est copiée que si elle diffère de celle de l'expression;
+		 * sinon, seules les valeurs sont écrites, sans aucune allocation.
+		 */
+		template <typename Expression>
+		BlockSparseMatrix& operator=(const BlockSparseExpression<Expression>& expression)
+		{
+			const BlockSparseMatrix& pattern = expression.derived().pattern();
+			if (&pattern != this && !hasSamePattern(pattern))
+			{
+				copyPattern(pattern);
+			}
+			expression.derived().evaluateTo(*this);
+
+			return *this;
+		}
+
+		/**
+		 * Construit la structure de la matrice à partir de la liste des blocs
+		 * non nuls, identifiés par leur (ligne de bloc, colonne de bloc).
+		 *
+		 * Les doublons sont permis et les blocs diagonaux sont toujours ajoutés.
+		 * Les valeurs sont initialisées à zéro.
+		 */
+		void setPattern(int blockRows, const std::vector<std::pair<int, int>>& blocks)
+		{
+			ASSERT(blockRows >= 0, "Attempting to create a block sparse matrix with a negative size");
+
+			m_blockRows = blockRows;
+
+			std::vector<std::vector<int>> colsPerRow(blockRows);
+			for (auto i = 0; i < blockRows; ++i)
+			{
+				colsPerRow[i].push_back(i);
+			}
+
+			for (const auto& block : blocks)
+			{
+				ASSERTF(block.first >= 0 && block.first < blockRows && block.second >= 0 && block.second < blockRows,
+				        "Trying to add a block out of range (%d, %d)", block.first, block.second);
+				colsPerRow[block.first].push_back(block.second);
+			}
+
+			m_rowPointers.assign(blockRows + 1, 0);
+			m_colIndices.clear();
+			m_diagonalIndices.assign(blockRows, -1);
+			for (auto i = 0; i < blockRows; ++i)
+			{
+				auto& cols = colsPerRow[i];
+				std::sort(cols.begin(), cols.end());
+				cols.erase(std::unique(cols.begin(), cols.end()), cols.end());
+
+				for (int col : cols)
+				{
+					if (col == i)
+					{
+						m_diagonalIndices[i] = static_cast<int>(m_colIndices.size());
+					}
+					m_colIndices.push_back(col);
+				}
+				m_rowPointers[i + 1] = static_cast<int>(m_colIndices.size());
+			}
+
+			m_values.assign(m_colIndices.size() * BlockLength, static_cast<Scalar>(0));
+		}
+
+		/**
+		 * Indique si les deux matrices partagent exactement la même structure
+		 */
+		bool hasSamePattern(const BlockSparseMatrix& other) const
+		{
+			return m_blockRows == other.m_blockRows && m_rowPointers == other.m_rowPointers && m_colIndices == other.m_colIndices;
+		}
+
+		/**
+		 * Copie la structure d'une autre matrice. La mémoire déjà réservée est
+		 * réutilisée; les valeurs ne sont pas initialisées.
+		 */
+		void copyPattern(const BlockSparseMatrix& other)
+		{
+			m_blockRows = other.m_blockRows;
+			m_rowPointers = other.m_rowPointers;
+			m_colIndices = other.m_colIndices;
+			m_diagonalIndices = other.m_diagonalIndices;
+			m_values.resize(other.m_values.size());
+		}
+
+		/**
+		 * Met toutes les valeurs à zéro sans modifier la structure.
+		 */
+		void setZero()
+		{
+			std::fill(m_values.begin(), m_values.end(), static_cast<Scalar>(0));
+		}
+
+		/**
+		 * Multiplie toutes les valeurs par un scalaire.
+		 */
+		void scale(Scalar scalar)
+		{
+			for (auto& value : m_values)
+			{
+				value *= scalar;
+			}
+		}
+
+		inline int rows() const { return BlockSize * m_blockRows; }
+		inline int cols() const { return BlockSize * m_blockRows; }
+		inline int blockRows() const { return m_blockRows; }
+		inline int nonZeroBlocks() const { return static_cast<int>(m_colIndices.size()); }
+
+		/**
+		 * Intervalle [blockRowBegin, blockRowEnd[ des indices des blocs d'une ligne de blocs.
+		 */
+		inline int blockRowBegin(int blockRow) const { return m_rowPointers[blockRow]; }
+		inline int blockRowEnd(int blockRow) const { return m_rowPointers[blockRow + 1]; }
+
+		/**
+		 * Colonne de bloc du bloc d'indice `blockIndex`
+		 */
+		inline int blockCol(int blockIndex) const { return m_colIndices[blockIndex]; }
+
+		/**
+		 * Indice du bloc diagonal de la ligne de blocs `blockRow`
+		 */
+		inline int diagonalBlock(int blockRow) const { return m_diagonalIndices[blockRow]; }
+
+		/**
+		 * Accès aux valeurs (par lignes) du bloc d'indice `blockIndex` (lecture seule)
+		 */
+		inline const Scalar* block(int blockIndex) const { return m_values.data() + BlockLength * blockIndex; }
+
+		/**
+		 * Accès aux valeurs (par lignes) du bloc d'indice `blockIndex` (lecture et écriture)
+		 */
+		inline Scalar* block(int blockIndex) { return m_values.data() + BlockLength * blockIndex; }
+
+		/**
+		 * Accès à la structure de la matrice (lecture seule)
+		 */
+		const std::vector<int>& rowPointers() const { return m_rowPointers; }
+		const std::vector<int>& colIndices() const { return m_colIndices; }
+
+		/**
+		 * Accès à l'ensemble des valeurs de la matrice
+		 */
+		const std::vector<Scalar>& values() const { return m_values; }
+		std::vector<Scalar>& values() { return m_values; }
+
+		/**
+		 * Retourne l'indice du bloc (blockRow, blockCol), ou -1 si ce bloc ne fait
+		 * pas partie de la structure.
+		 */
+		int findBlock(int blockRow, int blockCol) const
+		{
+			ASSERTF(blockRow >= 0 && blockRow < m_blockRows, "Trying to find a block out of range (blockRow = %d; blockRows = %d)", blockRow, m_blockRows);
+
+			const auto begin = m_colIndices.begin() + m_rowPointers[blockRow];
+			const auto end = m_colIndices.begin() + m_rowPointers[blockRow + 1];
+			const auto found = std::lower_bound(begin, end, blockCol);
+
+			if (found == end || *found != blockCol)
+			{
+				return -1;
+			}
+			return static_cast<int>(found - m_colIndices.begin());
+		}
+
+		/**
+		 * Accesseur à une entrée de la matrice (lecture seule).
+		 *
+		 * Cette méthode effectue une recherche dans la structure et ne devrait pas
+		 * être utilisée dans les boucles critiques.
+		 */
+		Scalar operator()(int i, int j) const
+		{
+			ASSERTF(i >= 0 && i < rows(), "Trying to access out of matrix range (i = %d; rows = %d)", i, rows());
+			ASSERTF(j >= 0 && j < cols(), "Trying to access out of matrix range (j = %d; cols = %d)", j, cols());
+
+			const int blockIndex = findBlock(i / BlockSize, j / BlockSize);
+			if (blockIndex < 0)
+			{
+				return static_cast<Scalar>(0);
+			}
+			return block(blockIndex)[(i % BlockSize) * BlockSize + (j % BlockSize)];
+		}
+
+		/**
+		 * Retourne la matrice sous la forme d'une matrice dense.
+		 *
+		 * Utile pour les tests et les solveurs directs denses seulement.
+		 */
+		Matrix<Scalar, Dynamic, Dynamic> toDense() const
+		{
+			Matrix<Scalar, Dynamic, Dynamic> dense(rows(), cols());
+			dense.setZero();
+
+			for (auto blockRow = 0; blockRow < m_blockRows; ++blockRow)
+			{
+				for (auto k = blockRowBegin(blockRow); k < blockRowEnd(blockRow); ++k)
+				{
+					const Scalar* values = block(k);
+					const int i = BlockSize * blockRow;
+					const int j = BlockSize * blockCol(k);
+
+					dense(i, j) = values[0];
+					dense(i, j + 1) = values[1];
+					dense(i + 1, j) = values[2];
+					dense(i + 1, j + 1) = values[3];
+				}
+			}
+
+			return dense;
+		}
+	};
+}
@@ -10,8 +10,12 @@
  *
  */
 
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <initializer_list>
+#include <new>
+#include <utility>
 
 #include "GTIAssert.h"
 
@@ -22,6 +26,31 @@ namespace gti320
 		Dynamic = -1
 	};
 
+	/**
+	 * Alignement, en octets, des tampons des stockages dynamiques : une ligne
+	 * de cache, soit la largeur d'un registre AVX-512 (voir Simd.h).
+	 */
+	constexpr std::size_t StorageAlignment = 64;
+
+	/**
+	 * Alloue un tampon non initialisé de `size` scalaires aligné sur
+	 * `StorageAlignment` octets.
+	 */
+	template <typename Scalar>
+	inline Scalar* allocateAligned(int size)
+	{
+		return static_cast<Scalar*>(::operator new(sizeof(Scalar) * size, std::align_val_t(StorageAlignment)));
+	}
+
+	/**
+	 * Libère un tampon obtenu avec `allocateAligned` (nullptr est accepté).
+	 */
+	template <typename Scalar>
+	inline void freeAligned(Scalar* data)
+	{
+		::operator delete(data, std::align_val_t(StorageAlignment));
+	}
+
 	/**
 	 * Stockage à taille fixe.
 	 *
@@ -103,6 +132,16 @@ namespace gti320
 			return *this;
 		}
 
+		/**
+		 * Échange le contenu de deux stockages.
+		 *
+		 * Les éléments font partie de l'objet : ils sont échangés un à un.
+		 */
+		void swap(DenseStorage& other)
+		{
+			std::swap_ranges(m_data, m_data + Size, other.m_data);
+		}
+
 		/**
 		 * Retourne la taille du tampon
 		 */
@@ -156,6 +195,15 @@ namespace gti320
 	 * Stockage à taille dynamique.
 	 *
 	 * Le nombre de données à stocker est déterminé à l'exécution.
+	 *
+	 * Le tampon alloué peut être plus grand que le nombre d'éléments utilisés
+	 * (capacité) : réduire la taille, ou la ramener à une valeur déjà atteinte,
+	 * ne fait aucune allocation.
+	 *
+	 * Le stockage peut aussi référencer une mémoire externe (voir `map` et
+	 * Map.h). Il ne la libère alors jamais et sa taille ne peut pas changer :
+	 * un redimensionnement à une autre taille arrête le programme, même en
+	 * mode release. Les affectations écrivent directement dans cette mémoire.
 	 */
 	template <typename Scalar>
 	class DenseStorage<Scalar, Dynamic>
@@ -163,53 +211,80 @@ namespace gti320
 	private:
 		Scalar* m_data;
 		int m_size;
+		int m_capacity; // Nombre d'éléments alloués (m_size <= m_capacity)
+		bool m_ownsData; // Faux si m_data référence une mémoire externe
 
 	public:
 		/**
 		 * Constructeur par défaut
 		 */
-		DenseStorage() : m_data(nullptr), m_size(0)
+		DenseStorage() : m_data(nullptr), m_size(0), m_capacity(0), m_ownsData(true)
 		{
 		}
 
 		/**
 		 * Constructeur avec taille spécifiée
 		 */
-		explicit DenseStorage(int size) : m_data(nullptr), m_size(size)
+		explicit DenseStorage(int size) : m_data(nullptr), m_size(size), m_capacity(size), m_ownsData(true)
 		{
 			ASSERT(size >= 0, "Attempting to create a dense storage with a negative size");
 
-			m_data = new Scalar[size];
+			m_data = allocateAligned<Scalar>(size);
 			memset(m_data, 0, sizeof(Scalar) * m_size);
 		}
 
 		/**
 		 * Constructor avec taille (size) et données initiales (data).
 		 */
-		explicit DenseStorage(const Scalar* data, int size)
+		explicit DenseStorage(const Scalar* data, int size) : m_data(nullptr), m_size(size), m_capacity(size), m_ownsData(true)
 		{
 			ASSERT(size >= 0, "Attempting to create a dense storage with a negative size");
 			ASSERT(data != nullptr, "Attempting to create a dense storage with no data");
 
-			m_data = new Scalar[size];
+			m_data = allocateAligned<Scalar>(size);
 			memcpy(m_data, data, sizeof(Scalar) * size);
 		}
 
 		/**
 		 * Constructeur de copie
+		 *
+		 * La copie possède toujours son propre tampon, même si `other`
+		 * référence une mémoire externe.
 		 */
-		DenseStorage(const DenseStorage& other) : m_data(nullptr), m_size(other.m_size)
+		DenseStorage(const DenseStorage& other) : m_data(nullptr), m_size(other.m_size), m_capacity(other.m_size), m_ownsData(true)
 		{
-			m_data = new Scalar[m_size];
+			m_data = allocateAligned<Scalar>(m_size);
 			memcpy(m_data, other.m_data, sizeof(Scalar) * m_size);
 		}
 
+		/**
+		 * Constructeur de déplacement
+		 *
+		 * Le tampon de `other` est récupéré sans copie; `other` devient vide.
+		 * Une mémoire externe n'est jamais récupérée : elle est copiée, ce qui
+		 * alloue un tampon.
+		 */
+		DenseStorage(DenseStorage&& other) : m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity), m_ownsData(true)
+		{
+			if (!other.m_ownsData)
+			{
+				m_data = allocateAligned<Scalar>(m_size);
+				m_capacity = m_size;
+				memcpy(m_data, other.m_data, sizeof(Scalar) * m_size);
+				return;
+			}
+
+			other.m_data = nullptr;
+			other.m_size = 0;
+			other.m_capacity = 0;
+		}
+
 		/*
 		 * Constructeur par liste d'initialisation
 		 */
-		DenseStorage(std::initializer_list<Scalar> initializerList) : m_data(nullptr), m_size(initializerList.size())
+		DenseStorage(std::initializer_list<Scalar> initializerList) : m_data(nullptr), m_size(initializerList.size()), m_capacity(initializerList.size()), m_ownsData(true)
 		{
-			m_data = new Scalar[m_size];
+			m_data = allocateAligned<Scalar>(m_size);
 			memcpy(m_data, initializerList.begin(), sizeof(Scalar) * m_size);
 		}
 
@@ -223,46 +298,182 @@ namespace gti320
 				return *this;
 			}
 
-			// On alloue un nouveau tampon de la bonne taille avant de copier les éléments
-			if (m_size != other.m_size)
+			// Le tampon actuel est réutilisé s'il est assez grand
+			resize(other.m_size);
+
+			memcpy(m_data, other.m_data, sizeof(Scalar) * m_size);
+
+			return *this;
+		}
+
+		/**
+		 * Opérateur de déplacement
+		 *
+		 * L'ancien tampon est libéré et celui de `other` est récupéré sans copie.
+		 * Si l'un des deux stockages référence une mémoire externe, les éléments
+		 * sont plutôt copiés, ce qui peut allouer.
+		 */
+		DenseStorage& operator=(DenseStorage&& other)
+		{
+			if (!m_ownsData || !other.m_ownsData)
+			{
+				return *this = static_cast<const DenseStorage&>(other);
+			}
+
+			if (this != &other)
 			{
-				delete[] m_data;
+				freeAligned(m_data);
 
+				m_data = other.m_data;
 				m_size = other.m_size;
-				m_data = new Scalar[m_size];
-			}
+				m_capacity = other.m_capacity;
 
-			memcpy(m_data, other.m_data, sizeof(Scalar) * m_size);
+				other.m_data = nullptr;
+				other.m_size = 0;
+				other.m_capacity = 0;
+			}
 
 			return *this;
 		}
 
+		/**
+		 * Échange les tampons de deux stockages (aucune copie des éléments).
+		 *
+		 * Une mémoire externe reste attachée à son stockage : les éléments sont
+		 * alors échangés un à un, et les deux tailles doivent être égales.
+		 */
+		void swap(DenseStorage& other) noexcept
+		{
+			if (!m_ownsData || !other.m_ownsData)
+			{
+				VERIFY(m_size == other.m_size, "Attempting to swap a mapped dense storage with a storage of a different size");
+				std::swap_ranges(m_data, m_data + m_size, other.m_data);
+				return;
+			}
+
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+			std::swap(m_capacity, other.m_capacity);
+		}
+
 		/**
 		 * Destructeur
 		 */
 		~DenseStorage()
 		{
-			delete[] m_data;
+			if (m_ownsData)
+			{
+				freeAligned(m_data);
+			}
+		}
+
+		/**
+		 * Fait référencer au stockage les `size` éléments de `data`, sans copie.
+		 *
+		 * Le tampon possédé est libéré. La mémoire externe doit rester valide
+		 * tant que le stockage la référence; elle n'est jamais libérée.
+		 */
+		void map(Scalar* data, int size)
+		{
+			ASSERT(size >= 0, "Attempting to map a dense storage with a negative size");
+			ASSERT(data != nullptr || size == 0, "Attempting to map a dense storage with no data");
+
+			if (m_ownsData)
+			{
+				freeAligned(m_data);
+			}
+
+			m_data = data;
+			m_size = size;
+			m_capacity = size;
+			m_ownsData = false;
 		}
 
+		/**
+		 * Indique si le stockage référence une mémoire externe
+		 */
+		inline bool isMapped() const { return !m_ownsData; }
+
 		/**
 		 * Retourne la taille du tampon 
 		 */
 		inline int size() const { return m_size; }
 
 		/**
-		 * Redimensionne le tampon alloué pour le stockage.
-		 * La mémoire qui n'est plus utilisée doit être libérée.
+		 * Retourne le nombre d'éléments pouvant être stockés sans réallocation
+		 */
+		inline int capacity() const { return m_capacity; }
+
+		/**
+		 * Redimensionne le stockage pour qu'il contienne `size` élément(s).
+		 *
+		 * Un nouveau tampon n'est alloué que si `size` dépasse la capacité; le
+		 * contenu n'est pas conservé (voir `conservativeResize`).
 		 */
 		void resize(int size)
 		{
 			ASSERT(size >= 0, "Attempting to resize a dense storage with a negative size");
 
-			auto* newData = new Scalar[size];
+			if (!m_ownsData)
+			{
+				VERIFY(size == m_size, "Attempting to resize a mapped dense storage");
+				return;
+			}
+
+			if (size > m_capacity)
+			{
+				// Le nouveau tampon est alloué avant de libérer l'ancien : si
+				// l'allocation échoue, le stockage reste valide
+				auto* newData = allocateAligned<Scalar>(size);
+				freeAligned(m_data);
+
+				m_data = newData;
+				m_capacity = size;
+			}
+
+			m_size = size;
+		}
+
+		/**
+		 * Réserve de la mémoire pour au moins `capacity` éléments, sans changer
+		 * la taille ni le contenu du stockage.
+		 */
+		void reserve(int capacity)
+		{
+			ASSERT(capacity >= 0, "Attempting to reserve a negative capacity");
+
+			if (capacity > m_capacity)
+			{
+				VERIFY(m_ownsData, "Attempting to grow a mapped dense storage");
+
+				auto* newData = allocateAligned<Scalar>(capacity);
+				if (m_size > 0)
+				{
+					memcpy(newData, m_data, sizeof(Scalar) * m_size);
+				}
 
-			delete[] m_data;
+				freeAligned(m_data);
+
+				m_data = newData;
+				m_capacity = capacity;
+			}
+		}
+
+		/**
+		 * Redimensionne le stockage en conservant ses premiers éléments. Les
+		 * nouveaux éléments sont initialisés à zéro.
+		 */
+		void conservativeResize(int size)
+		{
+			ASSERT(size >= 0, "Attempting to resize a dense storage with a negative size");
+			VERIFY(m_ownsData || size == m_size, "Attempting to resize a mapped dense storage");
+
+			reserve(size);
+			if (size > m_size)
+			{
+				memset(m_data + m_size, 0, sizeof(Scalar) * (size - m_size));
+			}
 
-			m_data = newData;
 			m_size = size;
 		}
 
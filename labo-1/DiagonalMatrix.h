@@ -0,0 +1,128 @@
+#pragma once
+
+/**
+ * @file DiagonalMatrix.h
+ *
+ * @brief Matrice diagonale dont seule la diagonale est stockée.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include "GTIAssert.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+namespace gti320
+{
+	/**
+	 * Matrice carrée diagonale.
+	 *
+	 * Seuls les éléments de la diagonale sont stockés, dans un vecteur. Les
+	 * opérations sur ce type de matrice sont donc linéaires en fonction de sa
+	 * taille.
+	 */
+	template <typename Scalar = double, int Size = Dynamic>
+	class DiagonalMatrix
+	{
+	private:
+		Vector<Scalar, Size> m_diagonal;
+
+	public:
+		/**
+		 * Constructeur par défaut
+		 */
+		DiagonalMatrix() : m_diagonal()
+		{
+		}
+
+		/**
+		 * Constructeur avec taille spécifiée. La diagonale est initialisée à zéro.
+		 */
+		explicit DiagonalMatrix(int size) : m_diagonal(size)
+		{
+		}
+
+		/**
+		 * Constructeur à partir des éléments de la diagonale
+		 */
+		explicit DiagonalMatrix(const Vector<Scalar, Size>& diagonal) : m_diagonal(diagonal)
+		{
+		}
+
+		/**
+		 * Redimensionne la matrice. Les valeurs de la diagonale ne sont pas initialisées.
+		 */
+		void resize(int size)
+		{
+			m_diagonal.resize(size);
+		}
+
+		inline void setZero() { m_diagonal.setZero(); }
+
+		/**
+		 * Affecte l'identité à la matrice
+		 */
+		void setIdentity()
+		{
+			for (auto i = 0; i < m_diagonal.size(); ++i)
+			{
+				m_diagonal(i) = static_cast<Scalar>(1);
+			}
+		}
+
+		inline int rows() const { return m_diagonal.size(); }
+		inline int cols() const { return m_diagonal.size(); }
+
+		/**
+		 * Accès aux éléments de la diagonale
+		 */
+		const Vector<Scalar, Size>& diagonal() const { return m_diagonal; }
+		Vector<Scalar, Size>& diagonal() { return m_diagonal; }
+
+		/**
+		 * Accesseur à l'élément (i, i) de la matrice (lecture seule)
+		 */
+		Scalar operator()(int i) const
+		{
+			ASSERTF(i >= 0 && i < rows(), "Trying to access out of matrix range (i = %d; rows = %d)", i, rows());
+			return m_diagonal(i);
+		}
+
+		/**
+		 * Accesseur à l'élément (i, i) de la matrice (lecture et écriture)
+		 */
+		Scalar& operator()(int i)
+		{
+			ASSERTF(i >= 0 && i < rows(), "Trying to access out of matrix range (i = %d; rows = %d)", i, rows());
+			return m_diagonal(i);
+		}
+
+		/**
+		 * Accesseur à une entrée de la matrice (lecture seule). Les éléments hors
+		 * de la diagonale sont nuls.
+		 */
+		Scalar operator()(int i, int j) const
+		{
+			ASSERTF(j >= 0 && j < cols(), "Trying to access out of matrix range (j = %d; cols = %d)", j, cols());
+			return i == j ? (*this)(i) : static_cast<Scalar>(0);
+		}
+
+		/**
+		 * Retourne la matrice sous la forme d'une matrice dense.
+		 */
+		Matrix<Scalar, Size, Size> toDense() const
+		{
+			Matrix<Scalar, Size, Size> dense(rows(), cols());
+			dense.setZero();
+
+			for (auto i = 0; i < rows(); ++i)
+			{
+				dense(i, i) = m_diagonal(i);
+			}
+
+			return dense;
+		}
+	};
+}
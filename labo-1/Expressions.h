@@ -0,0 +1,538 @@
+#pragma once
+
+/**
+ * @file Expressions.h
+ *
+ * @brief Gabarits d'expressions (expression templates) pour les opérations
+ *        élément par élément sur les vecteurs et les matrices dynamiques.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+#include "DenseStorage.h"
+#include "GTIAssert.h"
+
+namespace gti320
+{
+	template <typename Scalar, int Rows>
+	class Vector;
+
+	template <typename Scalar, int RowsAtCompile, int ColsAtCompile, int StorageType>
+	class Matrix;
+
+	template <typename Scalar>
+	class BlockSparseMatrix;
+
+	template <typename Scalar, int Size>
+	class DiagonalMatrix;
+
+	template <typename PlainType>
+	class Map;
+
+	/*
+	 * Principe
+	 *
+	 * Les opérateurs +, - et la multiplication par un scalaire (ainsi que le
+	 * produit par une matrice diagonale) ne calculent pas leur résultat : ils
+	 * retournent un petit objet qui décrit l'opération. Une chaîne comme
+	 * `x + dt * v` forme ainsi un arbre d'expressions qui n'est évalué qu'à
+	 * l'affectation, en une seule boucle et sans vecteur temporaire.
+	 *
+	 * Les vecteurs et les matrices nommés sont conservés par référence dans
+	 * l'expression; les temporaires (par exemple le résultat de `A * x`) y sont
+	 * copiés afin qu'une expression conservée avec `auto` reste valide.
+	 *
+	 * Seuls les vecteurs et les matrices de taille dynamique sont concernés :
+	 * les objets de taille fixe ne font aucune allocation et conservent les
+	 * opérateurs habituels.
+	 *
+	 * Toutes les opérations étant élément par élément, une expression peut
+	 * référencer la destination de l'affectation (`x = x + dt * v`).
+	 */
+
+	/**
+	 * Classe de base des expressions vectorielles.
+	 */
+	template <typename Derived>
+	class VectorExpression
+	{
+	public:
+		inline const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+		inline int rows() const { return derived().size(); }
+		inline int cols() const { return 1; }
+
+		/**
+		 * Retourne la norme euclidienne à la 2 de l'expression (sans l'évaluer dans un vecteur)
+		 */
+		auto squaredNorm() const
+		{
+			decltype(derived()(0)) squaredNorm = 0;
+			for (auto i = 0; i < derived().size(); ++i)
+			{
+				const auto element = derived()(i);
+				squaredNorm += element * element;
+			}
+			return squaredNorm;
+		}
+
+		/**
+		 * Retourne la norme euclidienne de l'expression
+		 */
+		auto norm() const
+		{
+			return sqrt(squaredNorm());
+		}
+	};
+
+	/**
+	 * Classe de base des expressions matricielles.
+	 */
+	template <typename Derived>
+	class MatrixExpression
+	{
+	public:
+		inline const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+		inline int size() const { return derived().rows() * derived().cols(); }
+	};
+
+	/**
+	 * Classe de base des expressions de matrices creuses par blocs.
+	 *
+	 * Une expression de ce type partage la structure d'une matrice creuse
+	 * (`pattern`) et sait écrire ses valeurs dans une matrice de même structure
+	 * (`evaluateTo`).
+	 */
+	template <typename Derived>
+	class BlockSparseExpression
+	{
+	public:
+		inline const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+		template <typename Scalar>
+		inline bool hasSamePattern(const BlockSparseMatrix<Scalar>& other) const { return derived().pattern().hasSamePattern(other); }
+
+		inline int rows() const { return derived().pattern().rows(); }
+		inline int cols() const { return derived().pattern().cols(); }
+	};
+
+	/**
+	 * Type scalaire d'un opérande
+	 */
+	template <typename T>
+	struct ExpressionScalar
+	{
+		typedef typename T::ScalarType type;
+	};
+
+	template <typename Scalar, int Rows>
+	struct ExpressionScalar<Vector<Scalar, Rows>>
+	{
+		typedef Scalar type;
+	};
+
+	template <typename Scalar, int RowsAtCompile, int ColsAtCompile, int StorageType>
+	struct ExpressionScalar<Matrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>>
+	{
+		typedef Scalar type;
+	};
+
+	template <typename Scalar>
+	struct ExpressionScalar<BlockSparseMatrix<Scalar>>
+	{
+		typedef Scalar type;
+	};
+
+	template <typename PlainType>
+	struct ExpressionScalar<Map<PlainType>> : ExpressionScalar<typename std::remove_const<PlainType>::type>
+	{
+	};
+
+	/**
+	 * Indique si T est un vecteur, une matrice dynamique ou une matrice creuse
+	 * (les feuilles des expressions).
+	 */
+	template <typename T>
+	struct IsExpressionLeaf : std::false_type
+	{
+	};
+
+	template <typename Scalar>
+	struct IsExpressionLeaf<Vector<Scalar, Dynamic>> : std::true_type
+	{
+	};
+
+	template <typename Scalar, int StorageType>
+	struct IsExpressionLeaf<Matrix<Scalar, Dynamic, Dynamic, StorageType>> : std::true_type
+	{
+	};
+
+	template <typename Scalar>
+	struct IsExpressionLeaf<BlockSparseMatrix<Scalar>> : std::true_type
+	{
+	};
+
+	template <typename PlainType>
+	struct IsExpressionLeaf<Map<PlainType>> : IsExpressionLeaf<typename std::remove_const<PlainType>::type>
+	{
+	};
+
+	/**
+	 * Type sous lequel une feuille nommée est référencée dans une expression.
+	 * Un Map (voir Map.h) est référencé comme le vecteur ou la matrice qu'il
+	 * est, ce qui lui donne accès aux mêmes évaluations spécialisées.
+	 */
+	template <typename T>
+	struct ExpressionLeafType
+	{
+		typedef T type;
+	};
+
+	template <typename PlainType>
+	struct ExpressionLeafType<Map<PlainType>>
+	{
+		typedef typename std::remove_const<PlainType>::type type;
+	};
+
+	/**
+	 * Indique si T peut être un opérande d'une expression vectorielle
+	 */
+	template <typename T>
+	struct IsVectorOperand : std::is_base_of<VectorExpression<T>, T>
+	{
+	};
+
+	template <typename Scalar>
+	struct IsVectorOperand<Vector<Scalar, Dynamic>> : std::true_type
+	{
+	};
+
+	template <typename PlainType>
+	struct IsVectorOperand<Map<PlainType>> : IsVectorOperand<typename std::remove_const<PlainType>::type>
+	{
+	};
+
+	/**
+	 * Indique si T peut être un opérande d'une expression matricielle
+	 */
+	template <typename T>
+	struct IsMatrixOperand : std::is_base_of<MatrixExpression<T>, T>
+	{
+	};
+
+	template <typename Scalar, int StorageType>
+	struct IsMatrixOperand<Matrix<Scalar, Dynamic, Dynamic, StorageType>> : std::true_type
+	{
+	};
+
+	template <typename PlainType>
+	struct IsMatrixOperand<Map<PlainType>> : IsMatrixOperand<typename std::remove_const<PlainType>::type>
+	{
+	};
+
+	/**
+	 * Indique si T est une matrice diagonale de taille dynamique
+	 */
+	template <typename T>
+	struct IsDynamicDiagonal : std::false_type
+	{
+	};
+
+	template <typename Scalar>
+	struct IsDynamicDiagonal<DiagonalMatrix<Scalar, Dynamic>> : std::true_type
+	{
+		typedef Vector<Scalar, Dynamic> DiagonalType;
+	};
+
+	/**
+	 * Type sous lequel un opérande est conservé dans une expression : les
+	 * feuilles nommées (lvalues) par référence constante, tout le reste par
+	 * valeur.
+	 */
+	template <typename T>
+	using ExpressionOperand = typename std::conditional<
+		std::is_lvalue_reference<T>::value && IsExpressionLeaf<typename std::decay<T>::type>::value,
+		const typename ExpressionLeafType<typename std::decay<T>::type>::type&,
+		typename std::decay<T>::type>::type;
+
+	/**
+	 * Type sous lequel les éléments d'une matrice diagonale sont conservés dans
+	 * une expression (même règle que pour les autres feuilles).
+	 */
+	template <typename T>
+	using DiagonalOperand = typename std::conditional<
+		std::is_lvalue_reference<T>::value,
+		const typename IsDynamicDiagonal<typename std::decay<T>::type>::DiagonalType&,
+		typename IsDynamicDiagonal<typename std::decay<T>::type>::DiagonalType>::type;
+
+	/*
+	 * Opérations élément par élément
+	 */
+	struct AddOperation
+	{
+		template <typename Scalar>
+		static inline Scalar apply(Scalar left, Scalar right) { return left + right; }
+	};
+
+	struct SubtractOperation
+	{
+		template <typename Scalar>
+		static inline Scalar apply(Scalar left, Scalar right) { return left - right; }
+	};
+
+	struct MultiplyOperation
+	{
+		template <typename Scalar>
+		static inline Scalar apply(Scalar left, Scalar right) { return left * right; }
+	};
+
+	/**
+	 * Opération élément par élément entre deux expressions vectorielles de même taille
+	 */
+	template <typename Left, typename Right, typename Operation>
+	class VectorBinaryExpression : public VectorExpression<VectorBinaryExpression<Left, Right, Operation>>
+	{
+	private:
+		Left m_left;
+		Right m_right;
+
+	public:
+		typedef typename ExpressionScalar<typename std::decay<Left>::type>::type ScalarType;
+
+		template <typename LeftOperand, typename RightOperand>
+		VectorBinaryExpression(LeftOperand&& left, RightOperand&& right)
+			: m_left(std::forward<LeftOperand>(left)), m_right(std::forward<RightOperand>(right))
+		{
+			ASSERT(m_left.size() == m_right.size(), "Trying to combine two vectors of different sizes");
+		}
+
+		inline int size() const { return m_left.size(); }
+
+		inline const typename std::decay<Left>::type& left() const { return m_left; }
+		inline const typename std::decay<Right>::type& right() const { return m_right; }
+
+		inline ScalarType operator()(int i) const
+		{
+			return Operation::apply(static_cast<ScalarType>(m_left(i)), static_cast<ScalarType>(m_right(i)));
+		}
+	};
+
+	/**
+	 * Multiplication d'une expression vectorielle par un scalaire
+	 */
+	template <typename Operand>
+	class ScaledVectorExpression : public VectorExpression<ScaledVectorExpression<Operand>>
+	{
+	public:
+		typedef typename ExpressionScalar<typename std::decay<Operand>::type>::type ScalarType;
+
+	private:
+		ScalarType m_scalar;
+		Operand m_operand;
+
+	public:
+		template <typename OtherOperand>
+		ScaledVectorExpression(ScalarType scalar, OtherOperand&& operand)
+			: m_scalar(scalar), m_operand(std::forward<OtherOperand>(operand))
+		{
+		}
+
+		inline int size() const { return m_operand.size(); }
+
+		inline ScalarType scalar() const { return m_scalar; }
+		inline const typename std::decay<Operand>::type& operand() const { return m_operand; }
+
+		inline ScalarType operator()(int i) const { return m_scalar * m_operand(i); }
+	};
+
+	/**
+	 * Opération élément par élément entre deux expressions matricielles de même taille
+	 */
+	template <typename Left, typename Right, typename Operation>
+	class MatrixBinaryExpression : public MatrixExpression<MatrixBinaryExpression<Left, Right, Operation>>
+	{
+	private:
+		Left m_left;
+		Right m_right;
+
+	public:
+		typedef typename ExpressionScalar<typename std::decay<Left>::type>::type ScalarType;
+
+		template <typename LeftOperand, typename RightOperand>
+		MatrixBinaryExpression(LeftOperand&& left, RightOperand&& right)
+			: m_left(std::forward<LeftOperand>(left)), m_right(std::forward<RightOperand>(right))
+		{
+			ASSERT(m_left.rows() == m_right.rows(), "Trying to combine two matrices of different height");
+			ASSERT(m_left.cols() == m_right.cols(), "Trying to combine two matrices of different width");
+		}
+
+		inline int rows() const { return m_left.rows(); }
+		inline int cols() const { return m_left.cols(); }
+
+		inline ScalarType operator()(int i, int j) const
+		{
+			return Operation::apply(static_cast<ScalarType>(m_left(i, j)), static_cast<ScalarType>(m_right(i, j)));
+		}
+	};
+
+	/**
+	 * Multiplication d'une expression matricielle par un scalaire
+	 */
+	template <typename Operand>
+	class ScaledMatrixExpression : public MatrixExpression<ScaledMatrixExpression<Operand>>
+	{
+	public:
+		typedef typename ExpressionScalar<typename std::decay<Operand>::type>::type ScalarType;
+
+	private:
+		ScalarType m_scalar;
+		Operand m_operand;
+
+	public:
+		template <typename OtherOperand>
+		ScaledMatrixExpression(ScalarType scalar, OtherOperand&& operand)
+			: m_scalar(scalar), m_operand(std::forward<OtherOperand>(operand))
+		{
+		}
+
+		inline int rows() const { return m_operand.rows(); }
+		inline int cols() const { return m_operand.cols(); }
+
+		inline ScalarType operator()(int i, int j) const { return m_scalar * m_operand(i, j); }
+	};
+
+	/**
+	 * Multiplication d'une matrice creuse par blocs par un scalaire
+	 */
+	template <typename Operand>
+	class ScaledBlockSparseExpression : public BlockSparseExpression<ScaledBlockSparseExpression<Operand>>
+	{
+	public:
+		typedef typename ExpressionScalar<typename std::decay<Operand>::type>::type ScalarType;
+
+	private:
+		ScalarType m_scalar;
+		Operand m_matrix;
+
+	public:
+		template <typename OtherOperand>
+		ScaledBlockSparseExpression(ScalarType scalar, OtherOperand&& matrix)
+			: m_scalar(scalar), m_matrix(std::forward<OtherOperand>(matrix))
+		{
+		}
+
+		inline ScalarType scalar() const { return m_scalar; }
+		inline const BlockSparseMatrix<ScalarType>& matrix() const { return m_matrix; }
+
+		inline const BlockSparseMatrix<ScalarType>& pattern() const { return m_matrix; }
+
+		inline ScalarType operator()(int i, int j) const { return m_scalar * m_matrix(i, j); }
+
+		/**
+		 * Écrit les valeurs de l'expression dans `outMatrix`, qui doit avoir la
+		 * structure de l'expression.
+		 */
+		void evaluateTo(BlockSparseMatrix<ScalarType>& outMatrix) const
+		{
+			const auto& values = m_matrix.values();
+			auto& outValues = outMatrix.values();
+			for (auto p = 0; p < static_cast<int>(values.size()); ++p)
+			{
+				outValues[p] = m_scalar * values[p];
+			}
+		}
+	};
+
+	/**
+	 * Somme d'une matrice diagonale et d'une matrice creuse par blocs
+	 * multipliée par un scalaire : D + s * B.
+	 *
+	 * Le résultat partage la structure de B puisque ses blocs diagonaux en font
+	 * toujours partie.
+	 */
+	template <typename Diagonal, typename Sparse>
+	class DiagonalBlockSparseSumExpression : public BlockSparseExpression<DiagonalBlockSparseSumExpression<Diagonal, Sparse>>
+	{
+	private:
+		Diagonal m_diagonal; // éléments de la diagonale de D
+		Sparse m_sparse; // s * B
+
+	public:
+		typedef typename Sparse::ScalarType ScalarType;
+
+		template <typename DiagonalOperand, typename SparseOperand>
+		DiagonalBlockSparseSumExpression(DiagonalOperand&& diagonal, SparseOperand&& sparse)
+			: m_diagonal(std::forward<DiagonalOperand>(diagonal)), m_sparse(std::forward<SparseOperand>(sparse))
+		{
+			ASSERT(m_diagonal.size() == m_sparse.pattern().rows(), "Trying to add two matrices of different height");
+		}
+
+		inline const BlockSparseMatrix<ScalarType>& pattern() const { return m_sparse.pattern(); }
+
+		inline ScalarType operator()(int i, int j) const
+		{
+			return (i == j ? m_diagonal(i) : static_cast<ScalarType>(0)) + m_sparse(i, j);
+		}
+
+		void evaluateTo(BlockSparseMatrix<ScalarType>& outMatrix) const
+		{
+			m_sparse.evaluateTo(outMatrix);
+			for (auto blockRow = 0; blockRow < outMatrix.blockRows(); ++blockRow)
+			{
+				ScalarType* diagonalBlock = outMatrix.block(outMatrix.diagonalBlock(blockRow));
+				diagonalBlock[0] += m_diagonal(2 * blockRow);
+				diagonalBlock[3] += m_diagonal(2 * blockRow + 1);
+			}
+		}
+	};
+
+	/**
+	 * Indique si T peut être un opérande d'une expression de matrice creuse par
+	 * blocs : une matrice creuse ou une matrice creuse multipliée par un scalaire.
+	 */
+	template <typename T>
+	struct IsBlockSparseMatrix : std::false_type
+	{
+	};
+
+	template <typename Scalar>
+	struct IsBlockSparseMatrix<BlockSparseMatrix<Scalar>> : std::true_type
+	{
+	};
+
+	template <typename T>
+	struct IsBlockSparseOperand : IsBlockSparseMatrix<T>
+	{
+	};
+
+	template <typename Operand>
+	struct IsBlockSparseOperand<ScaledBlockSparseExpression<Operand>> : std::true_type
+	{
+	};
+
+	/**
+	 * Multiplie une matrice creuse par un scalaire
+	 */
+	template <typename SparseMatrix, typename std::enable_if<IsBlockSparseMatrix<typename std::decay<SparseMatrix>::type>::value, int>::type = 0>
+	ScaledBlockSparseExpression<ExpressionOperand<SparseMatrix>> makeScaledBlockSparse(typename ExpressionScalar<typename std::decay<SparseMatrix>::type>::type scalar, SparseMatrix&& matrix)
+	{
+		return ScaledBlockSparseExpression<ExpressionOperand<SparseMatrix>>(scalar, std::forward<SparseMatrix>(matrix));
+	}
+
+	/**
+	 * Multiplie une matrice creuse déjà multipliée par un scalaire : les deux
+	 * scalaires sont combinés afin de ne parcourir les valeurs qu'une seule fois.
+	 */
+	template <typename Operand>
+	ScaledBlockSparseExpression<Operand> makeScaledBlockSparse(typename ScaledBlockSparseExpression<Operand>::ScalarType scalar, const ScaledBlockSparseExpression<Operand>& expression)
+	{
+		return ScaledBlockSparseExpression<Operand>(scalar * expression.scalar(), expression.matrix());
+	}
+}
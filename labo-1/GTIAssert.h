@@ -41,3 +41,18 @@
 #define ASSERT(expression, message)
 #define ASSERTF(expression, message, ...)
 #endif
+
+#include <stdio.h>
+#include <cstdlib>
+
+// Vérification conservée en mode release : si l'expression est fausse, le
+// message est affiché sur stderr et le programme est arrêté. Réservée aux
+// erreurs qui corrompraient la mémoire si l'exécution continuait.
+#define VERIFY(expression, message)             \
+{                                               \
+	if (!(expression))                          \
+	{                                           \
+		fprintf(stderr, "%s\n", message);       \
+		std::abort();                           \
+	}                                           \
+}
@@ -0,0 +1,403 @@
+#pragma once
+
+/**
+ * @file Gemm.h
+ *
+ * @brief Produits denses : matrice-matrice (C += A * B) par blocs, avec
+ *        tampons compactés et micro-noyau vectorisé, et matrice-vecteur
+ *        (y = alpha * A * x + beta * y). Les deux sont parallélisés par OpenMP.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <algorithm>
+
+#include "DenseStorage.h"
+#include "Simd.h"
+
+namespace gti320
+{
+	/*
+	 * Organisation (à la GotoBLAS / BLIS)
+	 *
+	 * Les matrices sont découpées en blocs dimensionnés pour les caches :
+	 *  - un panneau de B de KC x NC éléments (cache L3), compacté par tranches
+	 *    de NR colonnes et partagé par tous les fils d'exécution;
+	 *  - un bloc de A de MC x KC éléments (cache L2), compacté par tranches de
+	 *    MR lignes, propre à chaque fil d'exécution.
+	 * Le micro-noyau calcule ensuite une tuile MR x NR de C entièrement dans les
+	 * registres, en lisant les tampons compactés de façon contiguë.
+	 *
+	 * Les matrices sont décrites par un pointeur et deux pas : l'élément (i, j)
+	 * se trouve à `data[i * rowStride + j * colStride]`. Les deux types de
+	 * stockage de Matrix (par lignes ou par colonnes) sont donc traités par le
+	 * même code, seul le compactage en dépend.
+	 */
+	template <typename Scalar>
+	struct GemmBlocking
+	{
+		typedef typename simd::PacketOf<Scalar>::Type Packet;
+
+		static constexpr int MR = 2 * Packet::Width; // Lignes d'une tuile du micro-noyau (deux registres)
+		static constexpr int NR = 6;                 // Colonnes d'une tuile du micro-noyau
+		static constexpr int KC = 256;               // Profondeur des blocs compactés
+		static constexpr int MC = 192;               // Lignes d'un bloc de A (multiple de MR)
+		static constexpr int NC = 4032;              // Colonnes d'un panneau de B (multiple de NR)
+	};
+
+	/**
+	 * En deçà de ce nombre de multiplications, le compactage coûte plus cher
+	 * qu'il ne rapporte : on utilise une simple triple boucle.
+	 */
+	constexpr long long GemmSmallThreshold = 32 * 32 * 32;
+
+	/**
+	 * Nombre de multiplications à partir duquel le produit est parallélisé
+	 */
+	constexpr long long GemmParallelThreshold = 128 * 128 * 128;
+
+	/**
+	 * Nombre d'éléments de A à partir duquel le produit matrice-vecteur est
+	 * parallélisé
+	 */
+	constexpr long long GemvParallelThreshold = 64 * 1024;
+
+	/**
+	 * Nombre de lignes de y traitées d'un bloc lorsque A est stockée par
+	 * colonnes : le segment de y reste en cache L1 pendant le parcours des
+	 * colonnes.
+	 */
+	constexpr int GemvRowBlock = 512;
+
+	namespace internal
+	{
+		/**
+		 * Compacte un bloc mc x kc de A en tranches de MR lignes. Dans une
+		 * tranche, les MR éléments d'une même colonne sont contigus; les lignes
+		 * manquantes de la dernière tranche sont complétées par des zéros.
+		 */
+		template <typename Scalar>
+		void packA(int mc, int kc, const Scalar* A, int rowStride, int colStride, Scalar* outPacked)
+		{
+			constexpr int MR = GemmBlocking<Scalar>::MR;
+
+			for (auto ir = 0; ir < mc; ir += MR)
+			{
+				const int rows = std::min(MR, mc - ir);
+				for (auto p = 0; p < kc; ++p)
+				{
+					const Scalar* column = A + ir * rowStride + p * colStride;
+					for (auto i = 0; i < rows; ++i)
+					{
+						outPacked[i] = column[i * rowStride];
+					}
+					for (auto i = rows; i < MR; ++i)
+					{
+						outPacked[i] = static_cast<Scalar>(0);
+					}
+					outPacked += MR;
+				}
+			}
+		}
+
+		/**
+		 * Compacte la tranche de NR colonnes de B commençant à `B` (kc lignes).
+		 * Les NR éléments d'une même ligne sont contigus; les colonnes
+		 * manquantes sont complétées par des zéros.
+		 */
+		template <typename Scalar>
+		void packBPanel(int kc, int cols, const Scalar* B, int rowStride, int colStride, Scalar* outPacked)
+		{
+			constexpr int NR = GemmBlocking<Scalar>::NR;
+
+			for (auto p = 0; p < kc; ++p)
+			{
+				const Scalar* row = B + p * rowStride;
+				for (auto j = 0; j < cols; ++j)
+				{
+					outPacked[j] = row[j * colStride];
+				}
+				for (auto j = cols; j < NR; ++j)
+				{
+					outPacked[j] = static_cast<Scalar>(0);
+				}
+				outPacked += NR;
+			}
+		}
+
+		/**
+		 * Micro-noyau : C(0:rows, 0:cols) += A * B pour une tuile MR x NR.
+		 *
+		 * Les 2 x NR accumulateurs restent dans les registres pendant toute la
+		 * boucle sur k; `rows` et `cols` ne limitent que l'écriture finale.
+		 */
+		template <typename Scalar>
+		void microKernel(int kc, const Scalar* packedA, const Scalar* packedB, Scalar* C, int rowStride, int colStride, int rows, int cols)
+		{
+			typedef typename GemmBlocking<Scalar>::Packet P;
+			typedef typename P::Type Register;
+			constexpr int W = P::Width;
+			constexpr int MR = GemmBlocking<Scalar>::MR;
+			constexpr int NR = GemmBlocking<Scalar>::NR;
+
+			Register c00 = P::zero(), c01 = P::zero();
+			Register c10 = P::zero(), c11 = P::zero();
+			Register c20 = P::zero(), c21 = P::zero();
+			Register c30 = P::zero(), c31 = P::zero();
+			Register c40 = P::zero(), c41 = P::zero();
+			Register c50 = P::zero(), c51 = P::zero();
+
+			for (auto p = 0; p < kc; ++p)
+			{
+				const Register a0 = P::load(packedA);
+				const Register a1 = P::load(packedA + W);
+				Register b;
+
+				b = P::set(packedB[0]);
+				c00 = P::multiplyAdd(a0, b, c00);
+				c01 = P::multiplyAdd(a1, b, c01);
+				b = P::set(packedB[1]);
+				c10 = P::multiplyAdd(a0, b, c10);
+				c11 = P::multiplyAdd(a1, b, c11);
+				b = P::set(packedB[2]);
+				c20 = P::multiplyAdd(a0, b, c20);
+				c21 = P::multiplyAdd(a1, b, c21);
+				b = P::set(packedB[3]);
+				c30 = P::multiplyAdd(a0, b, c30);
+				c31 = P::multiplyAdd(a1, b, c31);
+				b = P::set(packedB[4]);
+				c40 = P::multiplyAdd(a0, b, c40);
+				c41 = P::multiplyAdd(a1, b, c41);
+				b = P::set(packedB[5]);
+				c50 = P::multiplyAdd(a0, b, c50);
+				c51 = P::multiplyAdd(a1, b, c51);
+
+				packedA += MR;
+				packedB += NR;
+			}
+
+			// La tuile est d'abord écrite par colonnes dans un tampon local, puis
+			// ajoutée à C selon ses pas (et ses dimensions réelles).
+			alignas(64) Scalar tile[MR * NR];
+			P::store(tile + 0 * MR, c00);
+			P::store(tile + 0 * MR + W, c01);
+			P::store(tile + 1 * MR, c10);
+			P::store(tile + 1 * MR + W, c11);
+			P::store(tile + 2 * MR, c20);
+			P::store(tile + 2 * MR + W, c21);
+			P::store(tile + 3 * MR, c30);
+			P::store(tile + 3 * MR + W, c31);
+			P::store(tile + 4 * MR, c40);
+			P::store(tile + 4 * MR + W, c41);
+			P::store(tile + 5 * MR, c50);
+			P::store(tile + 5 * MR + W, c51);
+
+			for (auto j = 0; j < cols; ++j)
+			{
+				for (auto i = 0; i < rows; ++i)
+				{
+					C[i * rowStride + j * colStride] += tile[j * MR + i];
+				}
+			}
+		}
+	}
+
+	/**
+	 * C += A * B, où A est m x k, B est k x n et C est m x n.
+	 *
+	 * Chaque matrice est décrite par un pointeur et ses pas de ligne et de
+	 * colonne (voir plus haut). C ne doit pas chevaucher A ni B.
+	 */
+	template <typename Scalar>
+	void gemm(int m, int n, int k,
+	          const Scalar* A, int aRowStride, int aColStride,
+	          const Scalar* B, int bRowStride, int bColStride,
+	          Scalar* C, int cRowStride, int cColStride)
+	{
+		if (m == 0 || n == 0 || k == 0)
+		{
+			return;
+		}
+
+		const long long operations = static_cast<long long>(m) * n * k;
+		if (operations <= GemmSmallThreshold)
+		{
+			for (auto j = 0; j < n; ++j)
+			{
+				for (auto p = 0; p < k; ++p)
+				{
+					const Scalar b = B[p * bRowStride + j * bColStride];
+					for (auto i = 0; i < m; ++i)
+					{
+						C[i * cRowStride + j * cColStride] += A[i * aRowStride + p * aColStride] * b;
+					}
+				}
+			}
+			return;
+		}
+
+		typedef GemmBlocking<Scalar> Blocking;
+		constexpr int MR = Blocking::MR;
+		constexpr int NR = Blocking::NR;
+		constexpr int KC = Blocking::KC;
+		constexpr int MC = Blocking::MC;
+		constexpr int NC = Blocking::NC;
+
+		const int maxPanelCols = (std::min(NC, n) + NR - 1) / NR * NR;
+		DenseStorage<Scalar, Dynamic> packedB(KC * maxPanelCols);
+		const int numberOfRowBlocks = (m + MC - 1) / MC;
+
+		#pragma omp parallel if (operations >= GemmParallelThreshold)
+		{
+			DenseStorage<Scalar, Dynamic> packedA(MC * KC);
+
+			for (auto jc = 0; jc < n; jc += NC)
+			{
+				const int nc = std::min(NC, n - jc);
+				const int numberOfPanels = (nc + NR - 1) / NR;
+
+				for (auto pc = 0; pc < k; pc += KC)
+				{
+					const int kc = std::min(KC, k - pc);
+
+					// Compactage partagé du panneau de B
+					#pragma omp for
+					for (int panel = 0; panel < numberOfPanels; ++panel)
+					{
+						const int jr = panel * NR;
+						internal::packBPanel(kc, std::min(NR, nc - jr), B + pc * bRowStride + (jc + jr) * bColStride,
+						                     bRowStride, bColStride, packedB.data() + jr * kc);
+					}
+
+					// Chaque fil traite des blocs de lignes de C indépendants
+					#pragma omp for schedule(dynamic)
+					for (int rowBlock = 0; rowBlock < numberOfRowBlocks; ++rowBlock)
+					{
+						const int ic = rowBlock * MC;
+						const int mc = std::min(MC, m - ic);
+						internal::packA(mc, kc, A + ic * aRowStride + pc * aColStride, aRowStride, aColStride, packedA.data());
+
+						for (auto jr = 0; jr < nc; jr += NR)
+						{
+							for (auto ir = 0; ir < mc; ir += MR)
+							{
+								internal::microKernel(kc, packedA.data() + ir * kc, packedB.data() + jr * kc,
+								                      C + (ic + ir) * cRowStride + (jc + jr) * cColStride, cRowStride, cColStride,
+								                      std::min(MR, mc - ir), std::min(NR, nc - jr));
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	namespace internal
+	{
+		/**
+		 * y(i) = alpha * A(i, :) * x + beta * y(i), pour une ligne contiguë de A
+		 */
+		template <typename Scalar>
+		inline void gemvRow(int n, Scalar alpha, const Scalar* row, const Scalar* x, Scalar beta, Scalar* y)
+		{
+			const Scalar product = alpha * simd::dot(row, x, n);
+			*y = beta == static_cast<Scalar>(0) ? product : product + beta * *y;
+		}
+
+		/**
+		 * y = alpha * A * x + beta * y pour un segment de `rows` lignes de A et
+		 * de y, en accumulant les colonnes de A une à une.
+		 */
+		template <typename Scalar>
+		void gemvColumns(int rows, int n, Scalar alpha, const Scalar* A, int rowStride, int colStride,
+		                 const Scalar* x, Scalar beta, Scalar* y)
+		{
+			const Scalar zero = static_cast<Scalar>(0);
+			if (beta == zero)
+			{
+				std::fill(y, y + rows, zero);
+			}
+			else if (beta != static_cast<Scalar>(1))
+			{
+				simd::scale(beta, y, rows);
+			}
+
+			for (auto j = 0; j < n; ++j)
+			{
+				const Scalar* column = A + j * colStride;
+				const Scalar coefficient = alpha * x[j];
+				if (rowStride == 1)
+				{
+					simd::axpy(coefficient, column, y, rows);
+				}
+				else
+				{
+					for (auto i = 0; i < rows; ++i)
+					{
+						y[i] += coefficient * column[i * rowStride];
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * y = alpha * A * x + beta * y, où A est m x n.
+	 *
+	 * A est décrite par son pointeur et ses pas (voir plus haut); x et y sont
+	 * contigus et ne doivent pas se chevaucher. Comme dans BLAS, y n'est pas lu
+	 * lorsque beta est nul.
+	 *
+	 * Si les lignes de A sont contiguës, chaque élément de y est un produit
+	 * scalaire et les lignes sont réparties entre les fils d'exécution. Sinon,
+	 * y est découpé en segments de GemvRowBlock lignes; chaque fil accumule les
+	 * colonnes de A dans ses propres segments, sans conflit d'écriture.
+	 */
+	template <typename Scalar>
+	void gemv(int m, int n, Scalar alpha,
+	          const Scalar* A, int rowStride, int colStride,
+	          const Scalar* x, Scalar beta, Scalar* y)
+	{
+		// Les petits produits (par exemple ceux de Math3D) évitent la création
+		// d'une équipe de fils d'exécution
+		const bool parallel = static_cast<long long>(m) * n >= GemvParallelThreshold;
+
+		if (colStride == 1)
+		{
+			if (parallel)
+			{
+				#pragma omp parallel for
+				for (int i = 0; i < m; ++i)
+				{
+					internal::gemvRow(n, alpha, A + i * rowStride, x, beta, y + i);
+				}
+			}
+			else
+			{
+				for (auto i = 0; i < m; ++i)
+				{
+					internal::gemvRow(n, alpha, A + i * rowStride, x, beta, y + i);
+				}
+			}
+			return;
+		}
+
+		const int numberOfRowBlocks = (m + GemvRowBlock - 1) / GemvRowBlock;
+		if (parallel)
+		{
+			#pragma omp parallel for
+			for (int rowBlock = 0; rowBlock < numberOfRowBlocks; ++rowBlock)
+			{
+				const int begin = rowBlock * GemvRowBlock;
+				internal::gemvColumns(std::min(GemvRowBlock, m - begin), n, alpha, A + begin * rowStride, rowStride, colStride,
+				                      x, beta, y + begin);
+			}
+		}
+		else
+		{
+			internal::gemvColumns(m, n, alpha, A, rowStride, colStride, x, beta, y);
+		}
+	}
+}
@@ -0,0 +1,376 @@
+#pragma once
+
+/**
+ * @file Map.h
+ *
+ * @brief Vecteurs et matrices qui référencent une mémoire externe, sans copie.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <type_traits>
+
+#include "Expressions.h"
+#include "Gemm.h"
+#include "Matrix.h"
+#include "Operators.h"
+#include "Vector.h"
+#include "GTIAssert.h"
+
+namespace gti320
+{
+	/*
+	 * Deux façons de voir une mémoire externe comme un vecteur ou une matrice :
+	 *
+	 *  - Map<Vector<...>> et Map<Matrix<...>> référencent des éléments
+	 *    contigus. Ce sont des Vector et des Matrix : ils s'utilisent partout où
+	 *    ceux-ci sont attendus (opérateurs, expressions, gemv, solveurs) et
+	 *    profitent des mêmes noyaux vectorisés.
+	 *  - VectorView et MatrixView acceptent des pas quelconques (par exemple une
+	 *    coordonnée sur deux). Ils s'utilisent dans les expressions et les
+	 *    produits matrice-vecteur.
+	 *
+	 * Dans les deux cas, les affectations écrivent dans la mémoire référencée,
+	 * dont la taille ne peut pas changer, et copier une vue donne une seconde
+	 * vue sur la même mémoire. La mémoire doit rester valide tant qu'une vue la
+	 * référence.
+	 */
+
+	/**
+	 * Vecteur dynamique qui référence des éléments contigus
+	 */
+	template <typename Scalar>
+	class Map<Vector<Scalar, Dynamic>> : public Vector<Scalar, Dynamic>
+	{
+	public:
+		typedef Vector<Scalar, Dynamic> PlainType;
+
+		/**
+		 * Référence les `size` éléments de `data`
+		 */
+		Map(Scalar* data, int size) : PlainType()
+		{
+			this->m_storage.map(data, size);
+			this->m_rows = size;
+		}
+
+		/**
+		 * Constructeur de copie : la copie référence la même mémoire
+		 */
+		Map(const Map& other) : Map(const_cast<Scalar*>(other.data()), other.size())
+		{
+		}
+
+		/**
+		 * Copie les éléments de `other` dans la mémoire référencée
+		 */
+		Map& operator=(const Map& other)
+		{
+			return *this = static_cast<const PlainType&>(other);
+		}
+
+		Map& operator=(const PlainType& other)
+		{
+			ASSERT(other.size() == this->size(), "Trying to assign a vector of a different size to a map");
+
+			if (this->data() != other.data())
+			{
+				PlainType::operator=(other);
+			}
+			return *this;
+		}
+
+		/**
+		 * Évalue une expression dans la mémoire référencée (voir Expressions.h)
+		 */
+		template <typename Expression>
+		Map& operator=(const VectorExpression<Expression>& expression)
+		{
+			ASSERT(expression.derived().size() == this->size(), "Trying to assign an expression of a different size to a map");
+
+			PlainType::operator=(expression);
+			return *this;
+		}
+	};
+
+	/**
+	 * Vecteur dynamique qui référence des éléments contigus en lecture seule
+	 *
+	 * Il est utilisable partout où un `const Vector&` est attendu.
+	 */
+	template <typename Scalar>
+	class Map<const Vector<Scalar, Dynamic>> : public Vector<Scalar, Dynamic>
+	{
+	public:
+		typedef Vector<Scalar, Dynamic> PlainType;
+
+		/**
+		 * Référence les `size` éléments de `data`
+		 */
+		Map(const Scalar* data, int size) : PlainType()
+		{
+			this->m_storage.map(const_cast<Scalar*>(data), size);
+			this->m_rows = size;
+		}
+
+		/**
+		 * Constructeur de copie : la copie référence la même mémoire
+		 */
+		Map(const Map& other) : Map(other.data(), other.size())
+		{
+		}
+
+		Map& operator=(const Map& other) = delete;
+	};
+
+	/**
+	 * Matrice dynamique qui référence des éléments contigus, rangés selon le
+	 * type de stockage de la matrice
+	 */
+	template <typename Scalar, int StorageType>
+	class Map<Matrix<Scalar, Dynamic, Dynamic, StorageType>> : public Matrix<Scalar, Dynamic, Dynamic, StorageType>
+	{
+	public:
+		typedef Matrix<Scalar, Dynamic, Dynamic, StorageType> PlainType;
+
+		/**
+		 * Référence les `rows * cols` éléments de `data`
+		 */
+		Map(Scalar* data, int rows, int cols) : PlainType()
+		{
+			ASSERT(rows >= 0 && cols >= 0, "Trying to map a matrix with a negative size");
+
+			this->m_storage.map(data, rows * cols);
+			this->m_rows = rows;
+			this->m_cols = cols;
+		}
+
+		/**
+		 * Constructeur de copie : la copie référence la même mémoire
+		 */
+		Map(const Map& other) : Map(const_cast<Scalar*>(other.data()), other.rows(), other.cols())
+		{
+		}
+
+		/**
+		 * Copie les éléments de `other` dans la mémoire référencée
+		 */
+		Map& operator=(const Map& other)
+		{
+			return *this = static_cast<const PlainType&>(other);
+		}
+
+		Map& operator=(const PlainType& other)
+		{
+			ASSERT(other.rows() == this->rows() && other.cols() == this->cols(), "Trying to assign a matrix of a different size to a map");
+
+			if (this->data() != other.data())
+			{
+				PlainType::operator=(other);
+			}
+			return *this;
+		}
+
+		/**
+		 * Évalue une expression dans la mémoire référencée (voir Expressions.h)
+		 */
+		template <typename Expression>
+		Map& operator=(const MatrixExpression<Expression>& expression)
+		{
+			ASSERT(expression.derived().rows() == this->rows() && expression.derived().cols() == this->cols(), "Trying to assign an expression of a different size to a map");
+
+			PlainType::operator=(expression);
+			return *this;
+		}
+	};
+
+	/**
+	 * Vue sur `size` éléments espacés de `stride` éléments.
+	 *
+	 * `Scalar` peut être constant (VectorView<const double>) pour une vue en
+	 * lecture seule.
+	 */
+	template <typename Scalar>
+	class VectorView : public VectorExpression<VectorView<Scalar>>
+	{
+	public:
+		typedef typename std::remove_const<Scalar>::type ScalarType;
+
+	private:
+		Scalar* m_data;
+		int m_size;
+		int m_stride; // Distance, en éléments, entre deux éléments consécutifs
+
+	public:
+		VectorView(Scalar* data, int size, int stride = 1) : m_data(data), m_size(size), m_stride(stride)
+		{
+			ASSERT(size >= 0, "Trying to create a vector view with a negative size");
+			ASSERT(data != nullptr || size == 0, "Trying to create a vector view with no data");
+		}
+
+		/**
+		 * Vue sur un vecteur existant (tous ses éléments)
+		 */
+		VectorView(Vector<ScalarType, Dynamic>& vector) : VectorView(vector.data(), vector.size())
+		{
+		}
+
+		VectorView(const VectorView& other) = default;
+
+		inline int size() const { return m_size; }
+		inline int stride() const { return m_stride; }
+		inline Scalar* data() const { return m_data; }
+
+		inline ScalarType operator()(int i) const { return m_data[i * m_stride]; }
+		inline Scalar& operator()(int i) { return m_data[i * m_stride]; }
+
+		/**
+		 * Copie les éléments de `other` dans la mémoire référencée
+		 */
+		VectorView& operator=(const VectorView& other)
+		{
+			return assign(other);
+		}
+
+		VectorView& operator=(const Vector<ScalarType, Dynamic>& other)
+		{
+			ASSERT(other.size() == m_size, "Trying to assign a vector of a different size to a vector view");
+
+			for (auto i = 0; i < m_size; ++i)
+			{
+				m_data[i * m_stride] = other(i);
+			}
+			return *this;
+		}
+
+		/**
+		 * Évalue une expression dans la mémoire référencée.
+		 *
+		 * Comme pour les vecteurs, l'expression peut référencer la vue elle-même.
+		 */
+		template <typename Expression>
+		VectorView& operator=(const VectorExpression<Expression>& expression)
+		{
+			return assign(expression.derived());
+		}
+
+	private:
+		template <typename Expression>
+		VectorView& assign(const Expression& expression)
+		{
+			ASSERT(expression.size() == m_size, "Trying to assign an expression of a different size to a vector view");
+
+			for (auto i = 0; i < m_size; ++i)
+			{
+				m_data[i * m_stride] = expression(i);
+			}
+			return *this;
+		}
+	};
+
+	/**
+	 * Vue sur une matrice dont l'élément (i, j) se trouve à
+	 * `data[i * rowStride + j * colStride]` (voir Gemm.h).
+	 *
+	 * Une matrice stockée par colonnes dans un tableau dont les colonnes sont
+	 * espacées de `ld` éléments a ainsi les pas (1, ld).
+	 */
+	template <typename Scalar>
+	class MatrixView : public MatrixExpression<MatrixView<Scalar>>
+	{
+	public:
+		typedef typename std::remove_const<Scalar>::type ScalarType;
+
+	private:
+		Scalar* m_data;
+		int m_rows;
+		int m_cols;
+		int m_rowStride;
+		int m_colStride;
+
+	public:
+		MatrixView(Scalar* data, int rows, int cols, int rowStride, int colStride)
+			: m_data(data), m_rows(rows), m_cols(cols), m_rowStride(rowStride), m_colStride(colStride)
+		{
+			ASSERT(rows >= 0 && cols >= 0, "Trying to create a matrix view with a negative size");
+			ASSERT(data != nullptr || rows * cols == 0, "Trying to create a matrix view with no data");
+		}
+
+		MatrixView(const MatrixView& other) = default;
+
+		inline int rows() const { return m_rows; }
+		inline int cols() const { return m_cols; }
+		inline int rowStride() const { return m_rowStride; }
+		inline int colStride() const { return m_colStride; }
+		inline Scalar* data() const { return m_data; }
+
+		inline ScalarType operator()(int i, int j) const { return m_data[i * m_rowStride + j * m_colStride]; }
+		inline Scalar& operator()(int i, int j) { return m_data[i * m_rowStride + j * m_colStride]; }
+
+		/**
+		 * Copie les éléments de `other` dans la mémoire référencée
+		 */
+		MatrixView& operator=(const MatrixView& other)
+		{
+			return assign(other);
+		}
+
+		template <int Rows, int Cols, int StorageType>
+		MatrixView& operator=(const Matrix<ScalarType, Rows, Cols, StorageType>& other)
+		{
+			return assign(other);
+		}
+
+		/**
+		 * Évalue une expression dans la mémoire référencée
+		 */
+		template <typename Expression>
+		MatrixView& operator=(const MatrixExpression<Expression>& expression)
+		{
+			return assign(expression.derived());
+		}
+
+	private:
+		template <typename Expression>
+		MatrixView& assign(const Expression& expression)
+		{
+			ASSERT(expression.rows() == m_rows && expression.cols() == m_cols, "Trying to assign a matrix of a different size to a matrix view");
+
+			for (auto j = 0; j < m_cols; ++j)
+			{
+				for (auto i = 0; i < m_rows; ++i)
+				{
+					(*this)(i, j) = expression(i, j);
+				}
+			}
+			return *this;
+		}
+	};
+
+	/**
+	 * y = alpha * A * x + beta * y, pour une vue sur une matrice (voir gemv dans
+	 * Operators.h). y ne doit pas chevaucher A ni x.
+	 */
+	template <typename ViewScalar, typename Scalar>
+	void gemv(Scalar alpha, const MatrixView<ViewScalar>& A, const Vector<Scalar, Dynamic>& x, Scalar beta, Vector<Scalar, Dynamic>& y)
+	{
+		static_assert(std::is_same<typename MatrixView<ViewScalar>::ScalarType, Scalar>::value, "Trying to multiply a matrix view and a vector of different scalar types");
+		ASSERT(x.size() == A.cols(), "Trying to multiply a vector with a matrix of invalid size");
+
+		prepareGemvOutput(A.rows(), beta, y);
+		gemv(A.rows(), A.cols(), alpha, static_cast<const Scalar*>(A.data()), A.rowStride(), A.colStride(), x.data(), beta, y.data());
+	}
+
+	/**
+	 * Multiplication : Vue sur une matrice * Vecteur
+	 */
+	template <typename ViewScalar, typename Scalar>
+	Vector<Scalar, Dynamic> operator*(const MatrixView<ViewScalar>& matrix, const Vector<Scalar, Dynamic>& vector)
+	{
+		Vector<Scalar, Dynamic> result(matrix.rows());
+		gemv(static_cast<Scalar>(1), matrix, vector, static_cast<Scalar>(0), result);
+		return result;
+	}
+}
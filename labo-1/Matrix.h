@@ -12,10 +12,12 @@
 
 #include <ostream>
 #include <algorithm>
+#include <utility>
 
 #include "MatrixBase.h"
 #include "GTIAssert.h"
 #include "Vector.h"
+#include "Expressions.h"
 
 namespace gti320
 {
@@ -35,7 +37,14 @@ namespace gti320
 	void fillMatrixFromInitializerList(Matrix<Scalar, Rows, Cols, StorageType>& matrix, const std::initializer_list<std::initializer_list<Scalar>>& initializerList);
 
 	// NOUVEAU_LABO2
-	template <typename Scalar = double, int RowsAtCompile = Dynamic, int ColsAtCompile = Dynamic>
+	/**
+	 * Partie commune aux deux types de stockage des matrices.
+	 *
+	 * Le type de stockage est un paramètre du patron : l'accès à un élément est
+	 * résolu à la compilation (aucun appel virtuel) et se réduit à un
+	 * chargement indexé que le compilateur peut mettre en ligne et vectoriser.
+	 */
+	template <typename Scalar = double, int RowsAtCompile = Dynamic, int ColsAtCompile = Dynamic, int StorageType = ColumnStorage>
 	class GenericMatrix : public MatrixBase<Scalar, RowsAtCompile, ColsAtCompile>
 	{
 	public:
@@ -53,6 +62,13 @@ namespace gti320
 		{
 		}
 
+		/**
+		 * Constructeur de déplacement
+		 */
+		GenericMatrix(GenericMatrix&& other) : MatrixBase<Scalar, RowsAtCompile, ColsAtCompile>(std::move(other))
+		{
+		}
+
 		/**
 		 * Constructeur avec specification du nombre de ligne et de colonnes
 		 */
@@ -63,8 +79,26 @@ namespace gti320
 		/**
 		 * Destructeur
 		 */
-		virtual ~GenericMatrix()
+		~GenericMatrix()
+		{
+		}
+
+		/**
+		 * Opérateur de copie
+		 */
+		GenericMatrix& operator=(const GenericMatrix& other)
 		{
+			MatrixBase<Scalar, RowsAtCompile, ColsAtCompile>::operator=(other);
+			return *this;
+		}
+
+		/**
+		 * Opérateur de déplacement
+		 */
+		GenericMatrix& operator=(GenericMatrix&& other)
+		{
+			MatrixBase<Scalar, RowsAtCompile, ColsAtCompile>::operator=(std::move(other));
+			return *this;
 		}
 
 		/**
@@ -116,16 +150,76 @@ namespace gti320
 		/**
 		 * Accesseur a une entrée de la matrice (lecture seule)
 		 */
-		virtual Scalar operator()(int i, int j) const = 0;
+		inline Scalar operator()(int i, int j) const
+		{
+			ASSERTF(i >= 0 && i < this->rows(), "Trying to access out of matrix range (i = %d; rows = %d)", i, this->rows());
+			ASSERTF(j >= 0 && j < this->cols(), "Trying to access out of matrix range (j = %d; rows = %d)", j, this->cols());
+
+			return this->m_storage[storageIndex(i, j)];
+		}
 
 		/**
 		 * Accesseur a une entrée de la matrice (lecture ou écriture)
 		 */
-		virtual Scalar& operator()(int i, int j) = 0;
+		inline Scalar& operator()(int i, int j)
+		{
+			ASSERTF(i >= 0 && i < this->rows(), "Trying to access out of matrix range (i = %d; rows = %d)", i, this->rows());
+			ASSERTF(j >= 0 && j < this->cols(), "Trying to access out of matrix range (j = %d; rows = %d)", j, this->cols());
+
+			return this->m_storage[storageIndex(i, j)];
+		}
 
 		// Ami avec l'opérateur `<<` pour pouvoir être en mesure d'afficher la matrice à la console
-		template<typename OtherScalar, int OtherRows, int OtherCols>
-		friend std::ostream& operator<< (std::ostream& out, const GenericMatrix<OtherScalar, OtherRows, OtherCols>& matrix);
+		template<typename OtherScalar, int OtherRows, int OtherCols, int OtherStorage>
+		friend std::ostream& operator<< (std::ostream& out, const GenericMatrix<OtherScalar, OtherRows, OtherCols, OtherStorage>& matrix);
+
+	protected:
+		/**
+		 * Évalue une expression (voir Expressions.h) dans la matrice.
+		 *
+		 * La matrice n'est réallouée que si ses dimensions changent et elle est
+		 * parcourue dans l'ordre de son stockage.
+		 */
+		template <typename Expression>
+		void assignExpression(const MatrixExpression<Expression>& expression)
+		{
+			const Expression& source = expression.derived();
+			if (source.rows() != this->rows() || source.cols() != this->cols())
+			{
+				this->resize(source.rows(), source.cols());
+			}
+
+			if (StorageType == RowStorage)
+			{
+				for (auto i = 0; i < this->rows(); ++i)
+				{
+					for (auto j = 0; j < this->cols(); ++j)
+					{
+						(*this)(i, j) = source(i, j);
+					}
+				}
+			}
+			else
+			{
+				for (auto j = 0; j < this->cols(); ++j)
+				{
+					for (auto i = 0; i < this->rows(); ++i)
+					{
+						(*this)(i, j) = source(i, j);
+					}
+				}
+			}
+		}
+
+	private:
+		/**
+		 * Indice de l'élément (i, j) dans le stockage. La condition est évaluée à
+		 * la compilation.
+		 */
+		inline int storageIndex(int i, int j) const
+		{
+			return StorageType == RowStorage ? i * this->cols() + j : j * this->rows() + i;
+		}
 	};
 	// END_NOUVEAU_LABO2
 
@@ -136,27 +230,34 @@ namespace gti320
 	 * patron, voir plus bas)
 	 */
 	template <typename Scalar = double, int RowsAtCompile = Dynamic, int ColsAtCompile = Dynamic, int StorageType = ColumnStorage>
-	class Matrix : public GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>
+	class Matrix : public GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>
 	{
 	public:
 		/**
 		 * Constructeur par défaut
 		 */
-		Matrix() : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>()
+		Matrix() : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>()
 		{
 		}
 
 		/**
 		 * Constructeur de copie
 		 */
-		Matrix(const Matrix& other) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>(other)
+		Matrix(const Matrix& other) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>(other)
+		{
+		}
+
+		/**
+		 * Constructeur de déplacement
+		 */
+		Matrix(Matrix&& other) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>(std::move(other))
 		{
 		}
 
 		/**
 		 * Constructeur avec specification du nombre de ligne et de colonnes
 		 */
-		explicit Matrix(int rows, int cols) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>(rows, cols)
+		explicit Matrix(int rows, int cols) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>(rows, cols)
 		{
 		}
 
@@ -165,7 +266,7 @@ namespace gti320
 		 *
 		 * Ce constructeur est plus lent que les autres et ne devraient être utilisé qu'en cas de nécessité ou de test.
 		 */
-		Matrix(const std::initializer_list<std::initializer_list<Scalar>>& initializerList) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>()
+		Matrix(const std::initializer_list<std::initializer_list<Scalar>>& initializerList) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>()
 		{
 			fillMatrixFromInitializerList(*this, initializerList);
 		}
@@ -177,36 +278,51 @@ namespace gti320
 		{
 		}
 
+		/**
+		 * Opérateur de copie
+		 */
+		Matrix& operator=(const Matrix& other)
+		{
+			GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>::operator=(other);
+			return *this;
+		}
+
+		/**
+		 * Opérateur de déplacement
+		 */
+		Matrix& operator=(Matrix&& other)
+		{
+			GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>::operator=(std::move(other));
+			return *this;
+		}
+
 		/**
 		 * Opérateur de copie a partir d'une sous-matrice.
 		 */
 		template <typename OtherScalar, int OtherRows, int OtherCols, int OtherStorage>
 		Matrix & operator=(const SubMatrix<OtherScalar, OtherRows, OtherCols, OtherStorage>& submatrix)
 		{
-			GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>::operator=(submatrix);
+			GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>::operator=(submatrix);
 			return  *this;
 		}
 
 		/**
-		 * Accesseur a une entrée de la matrice (lecture seule)
+		 * Constructeur à partir d'une expression (voir Expressions.h)
 		 */
-		Scalar operator()(int i, int j) const override
+		template <typename Expression>
+		Matrix(const MatrixExpression<Expression>& expression) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, StorageType>()
 		{
-			ASSERTF(i >= 0 && i < this->rows(), "Trying to access out of matrix range (i = %d; rows = %d)", i, this->rows());
-			ASSERTF(j >= 0 && j < this->cols(), "Trying to access out of matrix range (j = %d; rows = %d)", j, this->cols());
-
-			return this->m_storage[j * this->rows() + i];
+			this->assignExpression(expression);
 		}
 
 		/**
-		 * Accesseur a une entrée de la matrice (lecture ou écriture)
+		 * Évalue une expression dans la matrice, sans matrice temporaire.
 		 */
-		Scalar& operator()(int i, int j) override
+		template <typename Expression>
+		Matrix& operator=(const MatrixExpression<Expression>& expression)
 		{
-			ASSERTF(i >= 0 && i < this->rows(), "Trying to access out of matrix range (i = %d; rows = %d)", i, this->rows());
-			ASSERTF(j >= 0 && j < this->cols(), "Trying to access out of matrix range (j = %d; rows = %d)", j, this->cols());
-
-			return this->m_storage[j * this->rows() + i];
+			this->assignExpression(expression);
+			return *this;
 		}
 
 		/**
@@ -359,27 +475,34 @@ namespace gti320
 	 * Classe Matrix specialisée pour un stockage par lignes
 	 */
 	template <typename Scalar, int RowsAtCompile, int ColsAtCompile>
-	class Matrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage> : public GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>
+	class Matrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage> : public GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage>
 	{
 	public:
 		/**
 		 * Constructeur par défaut
 		 */
-		Matrix() : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>()
+		Matrix() : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage>()
 		{
 		}
 
 		/**
 		 * Constructeur de copie
 		 */
-		Matrix(const Matrix& other) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>(other)
+		Matrix(const Matrix& other) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage>(other)
+		{
+		}
+
+		/**
+		 * Constructeur de déplacement
+		 */
+		Matrix(Matrix&& other) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage>(std::move(other))
 		{
 		}
 
 		/**
 		 * Constructeur avec specification du nombre de ligne et de colonnes
 		 */
-		explicit Matrix(int rows, int cols) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>(rows, cols)
+		explicit Matrix(int rows, int cols) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage>(rows, cols)
 		{
 		}
 
@@ -388,7 +511,7 @@ namespace gti320
 		 *
 		 * Ce constructeur est plus lent que les autres et ne devraient être utilisé qu'en cas de nécessité ou de test.
 		 */
-		Matrix(const std::initializer_list<std::initializer_list<Scalar>>& initializerList) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>()
+		Matrix(const std::initializer_list<std::initializer_list<Scalar>>& initializerList) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage>()
 		{
 			fillMatrixFromInitializerList(*this, initializerList);
 		}
@@ -400,36 +523,51 @@ namespace gti320
 		{
 		}
 
+		/**
+		 * Opérateur de copie
+		 */
+		Matrix& operator=(const Matrix& other)
+		{
+			GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage>::operator=(other);
+			return *this;
+		}
+
+		/**
+		 * Opérateur de déplacement
+		 */
+		Matrix& operator=(Matrix&& other)
+		{
+			GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage>::operator=(std::move(other));
+			return *this;
+		}
+
 		/**
 		 * Opérateur de copie a partir d'une sous-matrice.
 		 */
 		template <typename OtherScalar, int OtherRows, int OtherCols, int OtherStorage>
 		Matrix& operator=(const SubMatrix<OtherScalar, OtherRows, OtherCols, OtherStorage>& submatrix)
 		{
-			GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile>::operator=(submatrix);
+			GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage>::operator=(submatrix);
 			return *this;
 		}
 
 		/**
-		 * Accesseur a une entrée de la matrice (lecture seule)
+		 * Constructeur à partir d'une expression (voir Expressions.h)
 		 */
-		Scalar operator()(int i, int j) const override
+		template <typename Expression>
+		Matrix(const MatrixExpression<Expression>& expression) : GenericMatrix<Scalar, RowsAtCompile, ColsAtCompile, RowStorage>()
 		{
-			ASSERTF(i >= 0 && i < this->rows(), "Trying to access out of matrix range (i = %d; rows = %d)", i, this->rows());
-			ASSERTF(j >= 0 && j < this->cols(), "Trying to access out of matrix range (j = %d; rows = %d)", j, this->cols());
-
-			return this->m_storage[i * this->cols() + j];
+			this->assignExpression(expression);
 		}
 
 		/**
-		 * Accesseur a une entrée de la matrice (lecture ou écriture)
+		 * Évalue une expression dans la matrice, sans matrice temporaire.
 		 */
-		Scalar& operator()(int i, int j) override	
+		template <typename Expression>
+		Matrix& operator=(const MatrixExpression<Expression>& expression)
 		{
-			ASSERTF(i >= 0 && i < this->rows(), "Trying to access out of matrix range (i = %d; rows = %d)", i, this->rows());
-			ASSERTF(j >= 0 && j < this->cols(), "Trying to access out of matrix range (j = %d; rows = %d)", j, this->cols());
-
-			return this->m_storage[i * this->cols() + j];
+			this->assignExpression(expression);
+			return *this;
 		}
 
 		/**
@@ -581,8 +719,8 @@ namespace gti320
 	 * grosses où l'ordre du stockage a une importance pour la performance ne devraient donc pas utiliser
 	 * cet opérateur, puisqu'il ne nous est pas utile de les afficher.
 	 */
-	template<typename Scalar, int Rows, int Cols>
-	std::ostream& operator<< (std::ostream& out, const GenericMatrix<Scalar, Rows, Cols>& matrix)
+	template<typename Scalar, int Rows, int Cols, int StorageType>
+	std::ostream& operator<< (std::ostream& out, const GenericMatrix<Scalar, Rows, Cols, StorageType>& matrix)
 	{
 		for (int i = 0; i < matrix.rows(); ++i)
 		{
@@ -10,6 +10,8 @@
  *
  */
 
+#include <utility>
+
 #include "DenseStorage.h"
 #include "GTIAssert.h"
 
@@ -75,6 +77,14 @@ namespace gti320
 			return *this;
 		}
 
+		/**
+		 * Échange le contenu de deux matrices
+		 */
+		void swap(MatrixBase& other)
+		{
+			m_storage.swap(other.m_storage);
+		}
+
 		inline void setZero() { m_storage.setZero(); }
 		static inline int cols() { return Cols; }
 		static inline int rows() { return Rows; }
@@ -103,6 +113,14 @@ namespace gti320
 			return m_storage.data();
 		}
 
+		/**
+		 * Accès au tampon de données (lecture et écriture)
+		 */
+		Scalar* data()
+		{
+			return m_storage.data();
+		}
+
 		/*
 		 * Retourne l'élément du tampon à l'indice `i` en lecture
 		 */
@@ -146,6 +164,14 @@ namespace gti320
 		{
 		}
 
+		/**
+		 * Constructeur de déplacement
+		 */
+		MatrixBase(MatrixBase&& other) : m_storage(std::move(other.m_storage)), m_rows(other.m_rows)
+		{
+			other.m_rows = 0;
+		}
+
 		/**
 		 * Destructeur
 		 */
@@ -166,6 +192,29 @@ namespace gti320
 			return *this;
 		}
 
+		/**
+		 * Opérateur de déplacement
+		 */
+		MatrixBase& operator=(MatrixBase&& other)
+		{
+			if (this != &other)
+			{
+				m_storage = std::move(other.m_storage);
+				m_rows = other.m_rows;
+				other.m_rows = 0;
+			}
+			return *this;
+		}
+
+		/**
+		 * Échange le contenu de deux matrices (aucune copie des éléments)
+		 */
+		void swap(MatrixBase& other) noexcept
+		{
+			m_storage.swap(other.m_storage);
+			std::swap(m_rows, other.m_rows);
+		}
+
 		/**
 		 * Redimensionne la matrice
 		 */
@@ -177,6 +226,16 @@ namespace gti320
 			m_rows = rows;
 		}
 
+		/**
+		 * Réserve de la mémoire pour au moins `size` éléments, afin que les
+		 * redimensionnements suivants jusqu'à cette taille ne fassent aucune
+		 * allocation.
+		 */
+		void reserve(int size)
+		{
+			m_storage.reserve(size);
+		}
+
 		inline void setZero() { m_storage.setZero(); }
 		static inline int cols() { return Cols; }
 		inline int rows() const { return m_rows; }
@@ -205,6 +264,14 @@ namespace gti320
 			return m_storage.data();
 		}
 
+		/**
+		 * Accès au tampon de données (lecture et écriture)
+		 */
+		Scalar* data()
+		{
+			return m_storage.data();
+		}
+
 		/*
 		 * Retourne l'élément du tampon à l'indice `i` en lecture
 		 */
@@ -245,6 +312,14 @@ namespace gti320
 		{
 		}
 
+		/**
+		 * Constructeur de déplacement
+		 */
+		MatrixBase(MatrixBase&& other) : m_storage(std::move(other.m_storage)), m_cols(other.m_cols)
+		{
+			other.m_cols = 0;
+		}
+
 		/**
 		 * Destructeur
 		 */
@@ -266,6 +341,30 @@ namespace gti320
 			return *this;
 		}
 
+		/**
+		 * Opérateur de déplacement
+		 */
+		MatrixBase& operator=(MatrixBase&& other)
+		{
+			if (this != &other)
+			{
+				m_storage = std::move(other.m_storage);
+				m_cols = other.m_cols;
+				other.m_cols = 0;
+			}
+
+			return *this;
+		}
+
+		/**
+		 * Échange le contenu de deux matrices (aucune copie des éléments)
+		 */
+		void swap(MatrixBase& other) noexcept
+		{
+			m_storage.swap(other.m_storage);
+			std::swap(m_cols, other.m_cols);
+		}
+
 		/**
 		 * Redimensionne la matrice
 		 */
@@ -276,6 +375,16 @@ namespace gti320
 			m_cols = cols;
 		}
 
+		/**
+		 * Réserve de la mémoire pour au moins `size` éléments, afin que les
+		 * redimensionnements suivants jusqu'à cette taille ne fassent aucune
+		 * allocation.
+		 */
+		void reserve(int size)
+		{
+			m_storage.reserve(size);
+		}
+
 		inline void setZero() { m_storage.setZero(); }
 		inline int cols() const { return m_cols; }
 		static inline int rows() { return Rows; }
@@ -304,6 +413,14 @@ namespace gti320
 			return m_storage.data();
 		}
 
+		/**
+		 * Accès au tampon de données (lecture et écriture)
+		 */
+		Scalar* data()
+		{
+			return m_storage.data();
+		}
+
 		/*
 		 * Retourne l'élément du tampon à l'indice `i` en lecture
 		 */
@@ -345,6 +462,15 @@ namespace gti320
 		{
 		}
 
+		/**
+		 * Constructeur de déplacement
+		 */
+		MatrixBase(MatrixBase&& other) : m_storage(std::move(other.m_storage)), m_cols(other.m_cols), m_rows(other.m_rows)
+		{
+			other.m_cols = 0;
+			other.m_rows = 0;
+		}
+
 		/**
 		 * Destructeur
 		 */
@@ -365,6 +491,32 @@ namespace gti320
 			return *this;
 		}
 
+		/**
+		 * Opérateur de déplacement
+		 */
+		MatrixBase& operator=(MatrixBase&& other)
+		{
+			if (this != &other)
+			{
+				m_storage = std::move(other.m_storage);
+				m_cols = other.m_cols;
+				m_rows = other.m_rows;
+				other.m_cols = 0;
+				other.m_rows = 0;
+			}
+			return *this;
+		}
+
+		/**
+		 * Échange le contenu de deux matrices (aucune copie des éléments)
+		 */
+		void swap(MatrixBase& other) noexcept
+		{
+			m_storage.swap(other.m_storage);
+			std::swap(m_cols, other.m_cols);
+			std::swap(m_rows, other.m_rows);
+		}
+
 		/**
 		 * Redimensionne la matrice
 		 */
@@ -375,6 +527,16 @@ namespace gti320
 			m_cols = cols;
 		}
 
+		/**
+		 * Réserve de la mémoire pour au moins `size` éléments, afin que les
+		 * redimensionnements suivants jusqu'à cette taille ne fassent aucune
+		 * allocation.
+		 */
+		void reserve(int size)
+		{
+			m_storage.reserve(size);
+		}
+
 		inline void setZero() { m_storage.setZero(); }
 		inline int cols() const { return m_cols; }
 		inline int rows() const { return m_rows; }
@@ -403,6 +565,14 @@ namespace gti320
 			return m_storage.data();
 		}
 
+		/**
+		 * Accès au tampon de données (lecture et écriture)
+		 */
+		Scalar* data()
+		{
+			return m_storage.data();
+		}
+
 		/*
 		 * Retourne l'élément du tampon à l'indice `i` en lecture
 		 */
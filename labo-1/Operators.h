@@ -10,8 +10,15 @@
  *
  */
 
+#include <type_traits>
+#include <utility>
+
+#include "Expressions.h"
 #include "Matrix.h"
 #include "Vector.h"
+#include "BlockSparseMatrix.h"
+#include "DiagonalMatrix.h"
+#include "Gemm.h"
 #include "GTIAssert.h"
 
 /**
@@ -21,83 +28,30 @@
 namespace gti320
 {
 	/**
-	 * Multiplication : Matrix * Matrix (générique)
-	 */
-	template <typename Scalar, int RowsA, int ColsA, int StorageA, int RowsB, int ColsB, int StorageB>
-	Matrix<Scalar, RowsA, ColsB> operator*(const Matrix<Scalar, RowsA, ColsA, StorageA>& left, const Matrix<Scalar, RowsB, ColsB, StorageB>& right)
-	{
-		ASSERT(left.cols() == right.rows(), "Trying to multiply two matrices that are not compatible together");
-
-		// Puisqu'on ne peut pas inférer la méthode de stockage de la matrice, on ne peut pas faire d'optimisations et
-		// on doit utiliser la méthode générique
-		Matrix<Scalar, RowsA, ColsB> result(left.rows(), right.cols());
-		for (auto j = 0; j < right.cols(); ++j)
-		{
-			for (auto i = 0; i < left.rows(); ++i)
-			{
-				for (auto k = 0; k < left.cols(); ++k)
-				{
-					result(i, j) += left(i, k) * right(k, j);
-				}
-			}
-		}
-
-		return result;
-	}
-
-	/**
-	 * Multiplication : Matrix(colonnes) * Matrix(lignes)
-	 *
-	 * Spécialisation de l'opérateur de multiplication pour le cas où la matrice
-	 * de gauche utilise un stockage par colonnes.
+	 * Restreint un opérateur aux objets dont au moins une dimension est fixe.
+	 * Ceux-ci ne font aucune allocation et sont calculés immédiatement; les
+	 * objets entièrement dynamiques passent par les expressions (voir Expressions.h).
 	 */
-	template <typename Scalar>
-	Matrix<Scalar, Dynamic, Dynamic> operator*(const Matrix<Scalar, Dynamic, Dynamic, ColumnStorage>& left, const Matrix<Scalar, Dynamic, Dynamic, RowStorage>& right)
-	{
-		ASSERT(left.cols() == right.rows(), "Trying to multiply two matrices that are not compatible together");
-
-		// Le stockage des matrices est incompatible avec la multiplication de matrice traditionnel. On doit plutôt
-		// itérer sur les lignes et les colonnes avant d'itérer sur k.
-		Matrix<Scalar, Dynamic, Dynamic> result(left.rows(), right.cols());
-		for (auto k = 0; k < left.cols(); ++k)
-		{
-			for (auto j = 0; j < right.cols(); ++j)
-			{
-				for (auto i = 0; i < left.rows(); ++i)
-				{
-					result(i, j) += left(i, k) * right(k, j);
-				}
-			}
-		}
-
-		return result;
-	}
+	template <int First, int Second = Dynamic>
+	using EnableIfFixedSize = typename std::enable_if<First != Dynamic || Second != Dynamic, int>::type;
 
 	/**
-	 * Multiplication : Matrix(ligne) * Matrix(colonne)
+	 * Multiplication : Matrix * Matrix
 	 *
-	 * Spécialisation de l'opérateur de multiplication pour le cas où la matrice
-	 * de gauche utilise un stockage par lignes et celle de gauche un stockage
-	 * par colonnes.
+	 * Le produit est délégué à gemm (voir Gemm.h), qui lit chaque opérande
+	 * selon son type de stockage (par lignes ou par colonnes).
 	 */
-	template <typename Scalar>
-	Matrix<Scalar, Dynamic, Dynamic> operator*(const Matrix<Scalar, Dynamic, Dynamic, RowStorage>& left, const Matrix<Scalar, Dynamic, Dynamic, ColumnStorage>& right)
+	template <typename Scalar, int RowsA, int ColsA, int StorageA, int RowsB, int ColsB, int StorageB>
+	Matrix<Scalar, RowsA, ColsB> operator*(const Matrix<Scalar, RowsA, ColsA, StorageA>& left, const Matrix<Scalar, RowsB, ColsB, StorageB>& right)
 	{
 		ASSERT(left.cols() == right.rows(), "Trying to multiply two matrices that are not compatible together");
 
-		// La multiplication ligne x colonne est la plus simple: la façon dont l'information est stockée nous permet de faire une multiplication "normale"
-		// On itère sur k avant de changer les lignes et les colonnes
-		Matrix<Scalar, Dynamic, Dynamic> result(left.rows(), right.cols());
-		for (auto j = 0; j < right.cols(); ++j)
-		{
-			for (auto i = 0; i < left.rows(); ++i)
-			{
-				for (auto k = 0; k < left.cols(); ++k)
-				{
-					result(i, j) += left(i, k) * right(k, j);
-				}
-			}
-		}
+		// Le résultat est stocké par colonnes et initialisé à zéro
+		Matrix<Scalar, RowsA, ColsB> result(left.rows(), right.cols());
+		gemm(left.rows(), right.cols(), left.cols(),
+		     left.data(), StorageA == RowStorage ? left.cols() : 1, StorageA == RowStorage ? 1 : left.rows(),
+		     right.data(), StorageB == RowStorage ? right.cols() : 1, StorageB == RowStorage ? 1 : right.rows(),
+		     result.data(), 1, result.rows());
 
 		return result;
 	}
@@ -105,8 +59,11 @@ namespace gti320
 
 	/**
 	 * Addition : Matrix + Matrix (générique)
+	 *
+	 * Les matrices de taille dynamique sont additionnées par une expression
+	 * (voir plus bas).
 	 */
-	template <typename Scalar, int Rows, int Cols, int StorageA, int StorageB>
+	template <typename Scalar, int Rows, int Cols, int StorageA, int StorageB, EnableIfFixedSize<Rows, Cols> = 0>
 	Matrix<Scalar, Rows, Cols> operator+(const Matrix<Scalar, Rows, Cols, StorageA>& left, const Matrix<Scalar, Rows, Cols, StorageB>& right)
 	{
 		ASSERT(left.rows() == right.rows(), "Trying to add two matrices of different height");
@@ -126,61 +83,11 @@ namespace gti320
 		return result;
 	}
 
-	/**
-	 * Addition : Matrix(colonne) + Matrix(colonne)
-	 *
-	 * Spécialisation de l'opérateur d'addition pour le cas où les deux matrices
-	 * sont stockées par colonnes.
-	 */
-	template <typename Scalar>
-	Matrix<Scalar, Dynamic, Dynamic> operator+(const Matrix<Scalar, Dynamic, Dynamic, ColumnStorage>& left, const Matrix<Scalar, Dynamic, Dynamic, ColumnStorage>& right)
-	{
-		ASSERT(left.rows() == right.rows(), "Trying to add two matrices of different height");
-		ASSERT(left.cols() == right.cols(), "Trying to add two matrices of different width");
-
-		// Puisque les deux matrices sont par colonne, on itère sur les colonnes
-		Matrix<Scalar, Dynamic, Dynamic, ColumnStorage> result(left);
-		for (auto j = 0; j < result.cols(); ++j)
-		{
-			for (auto i = 0; i < result.rows(); ++i)
-			{
-				result(i, j) += right(i, j);
-			}
-		}
-
-		return result;
-	}
-
-	/**
-	 * Addition : Matrix(ligne) + Matrix(ligne)
-	 *
-	 * Spécialisation de l'opérateur d'addition pour le cas où les deux matrices
-	 * sont stockées par lignes.
-	 */
-	template <typename Scalar>
-	Matrix<Scalar, Dynamic, Dynamic, RowStorage> operator+(const Matrix<Scalar, Dynamic, Dynamic, RowStorage>& left, const Matrix<Scalar, Dynamic, Dynamic, RowStorage>& right)
-	{
-		ASSERT(left.rows() == right.rows(), "Trying to add two matrices of different height");
-		ASSERT(left.cols() == right.cols(), "Trying to add two matrices of different width");
-
-		// Puisque les deux matrices sont par ligne, on itère sur les lignes
-		Matrix<Scalar, Dynamic, Dynamic, RowStorage> result(left);
-		for (auto i = 0; i < result.rows(); ++i)
-		{
-			for (auto j = 0; j < result.cols(); ++j)
-			{
-				result(i, j) += right(i, j);
-			}
-		}
-
-		return result;
-	}
-
 	// NOUVEAU_LABO2
 	/**
-	 * Addition : Matrix - Matrix (générique)
+	 * Soustraction : Matrix - Matrix (générique)
 	 */
-	template <typename Scalar, int Rows, int Cols, int StorageA, int StorageB>
+	template <typename Scalar, int Rows, int Cols, int StorageA, int StorageB, EnableIfFixedSize<Rows, Cols> = 0>
 	Matrix<Scalar, Rows, Cols> operator-(const Matrix<Scalar, Rows, Cols, StorageA>& left, const Matrix<Scalar, Rows, Cols, StorageB>& right)
 	{
 		ASSERT(left.rows() == right.rows(), "Trying to substract two matrices of different height");
@@ -200,55 +107,6 @@ namespace gti320
 		return result;
 	}
 
-	/**
-	 * Addition : Matrix(colonne) - Matrix(colonne)
-	 *
-	 * Spécialisation de l'opérateur d'addition pour le cas où les deux matrices
-	 * sont stockées par colonnes.
-	 */
-	template <typename Scalar>
-	Matrix<Scalar, Dynamic, Dynamic> operator-(const Matrix<Scalar, Dynamic, Dynamic, ColumnStorage>& left, const Matrix<Scalar, Dynamic, Dynamic, ColumnStorage>& right)
-	{
-		ASSERT(left.rows() == right.rows(), "Trying to substract two matrices of different height");
-		ASSERT(left.cols() == right.cols(), "Trying to substract two matrices of different width");
-
-		// Puisque les deux matrices sont par colonne, on itère sur les colonnes
-		Matrix<Scalar, Dynamic, Dynamic, ColumnStorage> result(left);
-		for (auto j = 0; j < result.cols(); ++j)
-		{
-			for (auto i = 0; i < result.rows(); ++i)
-			{
-				result(i, j) -= right(i, j);
-			}
-		}
-
-		return result;
-	}
-
-	/**
-	 * Addition : Matrix(ligne) - Matrix(ligne)
-	 *
-	 * Spécialisation de l'opérateur d'addition pour le cas où les deux matrices
-	 * sont stockées par lignes.
-	 */
-	template <typename Scalar>
-	Matrix<Scalar, Dynamic, Dynamic, RowStorage> operator-(const Matrix<Scalar, Dynamic, Dynamic, RowStorage>& left, const Matrix<Scalar, Dynamic, Dynamic, RowStorage>& right)
-	{
-		ASSERT(left.rows() == right.rows(), "Trying to substract two matrices of different height");
-		ASSERT(left.cols() == right.cols(), "Trying to substract two matrices of different width");
-
-		// Puisque les deux matrices sont par ligne, on itère sur les lignes
-		Matrix<Scalar, Dynamic, Dynamic, RowStorage> result(left);
-		for (auto i = 0; i < result.rows(); ++i)
-		{
-			for (auto j = 0; j < result.cols(); ++j)
-			{
-				result(i, j) -= right(i, j);
-			}
-		}
-
-		return result;
-	}
 	// END_NOUVEAU_LABO2
 
 	/**
@@ -257,7 +115,7 @@ namespace gti320
 	 * Spécialisation de l'opérateur de multiplication par un scalaire pour le
 	 * cas d'une matrice stockée par colonnes.
 	 */
-	template <typename Scalar, int Rows, int Cols>
+	template <typename Scalar, int Rows, int Cols, EnableIfFixedSize<Rows, Cols> = 0>
 	Matrix<Scalar, Rows, Cols, ColumnStorage> operator*(const Scalar& scalar, const Matrix<Scalar, Rows, Cols, ColumnStorage>& matrix)
 	{
 		// On itère la matrice par colonne puisque c'est de cette façon qu'elle est stockée
@@ -279,7 +137,7 @@ namespace gti320
 	 * Spécialisation de l'opérateur de multiplication par un scalaire pour le
 	 * cas d'une matrice stockée par colonnes.
 	 */
-	template <typename Scalar, int Rows, int Cols>
+	template <typename Scalar, int Rows, int Cols, EnableIfFixedSize<Rows, Cols> = 0>
 	Matrix<Scalar, Rows, Cols, ColumnStorage> operator*(const Matrix<Scalar, Rows, Cols, ColumnStorage>& matrix, const Scalar& scalar)
 	{
 		return scalar * matrix;
@@ -291,7 +149,7 @@ namespace gti320
 	 * Spécialisation de l'opérateur de multiplication par un scalaire pour le
 	 * cas d'une matrice stockée par lignes.
 	 */
-	template <typename Scalar, int Rows, int Cols>
+	template <typename Scalar, int Rows, int Cols, EnableIfFixedSize<Rows, Cols> = 0>
 	Matrix<Scalar, Rows, Cols, RowStorage> operator*(const Scalar& scalar, const Matrix<Scalar, Rows, Cols, RowStorage>& matrix)
 	{
 		// On itère la matrice par lignes puisque c'est de cette façon qu'elle est stockée
@@ -313,7 +171,7 @@ namespace gti320
 	 * Spécialisation de l'opérateur de multiplication par un scalaire pour le
 	 * cas d'une matrice stockée par lignes.
 	 */
-	template <typename Scalar, int Rows, int Cols>
+	template <typename Scalar, int Rows, int Cols, EnableIfFixedSize<Rows, Cols> = 0>
 	Matrix<Scalar, Rows, Cols, RowStorage> operator*(const Matrix<Scalar, Rows, Cols, RowStorage>& matrix, const Scalar& scalar)
 	{
 		return scalar * matrix;
@@ -322,64 +180,62 @@ namespace gti320
 	/*
 	 *	Mupltiplication d'une matrice par -1
 	 */
-	template <typename Scalar, int Rows, int Cols, int StorageType>
+	template <typename Scalar, int Rows, int Cols, int StorageType, EnableIfFixedSize<Rows, Cols> = 0>
 	Matrix<Scalar, Rows, Cols, StorageType> operator-(const Matrix<Scalar, Rows, Cols, StorageType>& matrix)
 	{
 		return static_cast<Scalar>(-1) * matrix;
 	}
 
 	/**
-	 * Multiplication : Matrice(ligne) * Vecteur
-	 *
-	 * Spécialisation de l'opérateur de multiplication matrice*vecteur pour le
-	 * cas où la matrice est représentée par lignes.
+	 * Prépare le vecteur résultat d'un produit matrice-vecteur : lorsque beta
+	 * est nul, y n'est pas lu et peut être redimensionné.
 	 */
-	template <typename Scalar, int Rows, int Cols>
-	Vector<Scalar, Rows> operator*(const Matrix<Scalar, Rows, Cols, RowStorage>& matrix, const Vector<Scalar, Cols>& vector)
+	template <typename Scalar, int Rows>
+	void prepareGemvOutput(int rows, Scalar beta, Vector<Scalar, Rows>& y)
 	{
-		ASSERT(vector.size() == matrix.cols(), "Trying to multiply a vector with a matrix of invalid size");
-
-		// On itère la matrice par lignes puisque c'est de cette façon qu'elle est stockée
-		Vector<Scalar, Rows> result(matrix.rows());
-		for (auto i = 0; i < matrix.rows(); ++i)
+		if (beta == static_cast<Scalar>(0) && y.size() != rows)
 		{
-			for (auto j = 0; j < matrix.cols(); ++j)
-			{
-				result(i) += vector(j) * matrix(i, j);
-			}
+			y.resize(rows);
 		}
-
-		return result;
+		ASSERT(y.size() == rows, "Trying to accumulate a matrix-vector product in a vector of invalid size");
 	}
 
 	/**
-	 * Multiplication : Matrice(colonne) * Vecteur
+	 * y = alpha * A * x + beta * y
 	 *
-	 * Spécialisation de l'opérateur de multiplication matrice*vecteur pour le
-	 * cas où la matrice est représentée par colonnes.
+	 * Produit matrice-vecteur sans vecteur temporaire (voir gemv dans Gemm.h).
+	 * y ne doit pas être x.
 	 */
-	template <typename Scalar, int Rows, int Cols>
-	Vector<Scalar, Rows> operator*(const Matrix<Scalar, Rows, Cols, ColumnStorage>& matrix, const Vector<Scalar, Cols>& vector)
+	template <typename Scalar, int Rows, int Cols, int Storage>
+	void gemv(Scalar alpha, const Matrix<Scalar, Rows, Cols, Storage>& A, const Vector<Scalar, Cols>& x, Scalar beta, Vector<Scalar, Rows>& y)
 	{
-		ASSERT(vector.size() == matrix.cols(), "Trying to multiply a vector with a matrix of invalid size");
+		ASSERT(x.size() == A.cols(), "Trying to multiply a vector with a matrix of invalid size");
+		ASSERT(static_cast<const void*>(&x) != static_cast<const void*>(&y), "Trying to write a matrix-vector product in its own operand");
 
-		// On itère la matrice par colonne puisque c'est de cette façon qu'elle est stockée
-		Vector<Scalar, Rows> result(matrix.rows());
-		for (auto j = 0; j < matrix.cols(); ++j)
-		{
-			for (auto i = 0; i < matrix.rows(); ++i)
-			{
-				result(i) += vector(j) * matrix(i, j);
-			}
-		}
+		prepareGemvOutput(A.rows(), beta, y);
+		gemv(A.rows(), A.cols(), alpha,
+		     A.data(), Storage == RowStorage ? A.cols() : 1, Storage == RowStorage ? 1 : A.rows(),
+		     x.data(), beta, y.data());
+	}
 
+	/**
+	 * Multiplication : Matrice * Vecteur
+	 *
+	 * Le produit est calculé par gemv, qui parcourt la matrice selon son type
+	 * de stockage.
+	 */
+	template <typename Scalar, int Rows, int Cols, int Storage>
+	Vector<Scalar, Rows> operator*(const Matrix<Scalar, Rows, Cols, Storage>& matrix, const Vector<Scalar, Cols>& vector)
+	{
+		Vector<Scalar, Rows> result(matrix.rows());
+		gemv(static_cast<Scalar>(1), matrix, vector, static_cast<Scalar>(0), result);
 		return result;
 	}
 
 	/**
 	 * Multiplication : Scalaire * Vecteur
 	 */
-	template <typename Scalar, int Rows>
+	template <typename Scalar, int Rows, EnableIfFixedSize<Rows> = 0>
 	Vector<Scalar, Rows> operator*(const Scalar& scalar, const Vector<Scalar, Rows>& vector)
 	{
 		Vector<Scalar, Rows> result(vector);
@@ -393,7 +249,7 @@ namespace gti320
 	/**
 	 * Multiplication : Vecteur * Scalaire 
 	 */
-	template <typename Scalar, int Rows>
+	template <typename Scalar, int Rows, EnableIfFixedSize<Rows> = 0>
 	Vector<Scalar, Rows> operator*(const Vector<Scalar, Rows>& vector, const Scalar& scalar)
 	{
 		return scalar * vector;
@@ -403,7 +259,7 @@ namespace gti320
 	/**
 	 * Addition : Vecteur + Vecteur
 	 */
-	template <typename Scalar, int RowsA, int RowsB>
+	template <typename Scalar, int RowsA, int RowsB, EnableIfFixedSize<RowsA, RowsB> = 0>
 	Vector<Scalar, RowsA> operator+(const Vector<Scalar, RowsA>& left, const Vector<Scalar, RowsB>& right)
 	{
 		auto minSize = std::min(left.size(), right.size());
@@ -419,7 +275,7 @@ namespace gti320
 	/**
 	 * Soustraction : Vecteur - Vecteur
 	 */
-	template <typename Scalar, int RowsA, int RowsB>
+	template <typename Scalar, int RowsA, int RowsB, EnableIfFixedSize<RowsA, RowsB> = 0>
 	Vector<Scalar, RowsA> operator-(const Vector<Scalar, RowsA>& left, const Vector<Scalar, RowsB>& right)
 	{
 		auto minSize = std::min(left.size(), right.size());
@@ -435,9 +291,236 @@ namespace gti320
 	/*
 	 *	Mupltiplication d'un vecteur
 	 */
-	template <typename Scalar, int Rows>
+	template <typename Scalar, int Rows, EnableIfFixedSize<Rows> = 0>
 	Vector<Scalar, Rows> operator-(const Vector<Scalar, Rows>& vector)
 	{
 		return static_cast<Scalar>(-1) * vector;
 	}
+
+	/**
+	 * y = alpha * A * x + beta * y, pour une matrice creuse par blocs
+	 *
+	 * Seuls les blocs présents dans la structure de la matrice sont parcourus.
+	 * Chaque ligne de blocs écrit ses deux éléments de y : les lignes sont
+	 * réparties entre les fils d'exécution sans conflit. y ne doit pas être x.
+	 */
+	template <typename Scalar>
+	void gemv(Scalar alpha, const BlockSparseMatrix<Scalar>& A, const Vector<Scalar, Dynamic>& x, Scalar beta, Vector<Scalar, Dynamic>& y)
+	{
+		ASSERT(x.size() == A.cols(), "Trying to multiply a vector with a matrix of invalid size");
+		ASSERT(&x != &y, "Trying to write a matrix-vector product in its own operand");
+
+		prepareGemvOutput(A.rows(), beta, y);
+
+		const Scalar* in = x.data();
+		Scalar* out = y.data();
+		const bool accumulate = beta != static_cast<Scalar>(0);
+
+		#pragma omp parallel for if (static_cast<long long>(A.nonZeroBlocks()) * BlockSparseMatrix<Scalar>::BlockLength >= GemvParallelThreshold)
+		for (int blockRow = 0; blockRow < A.blockRows(); ++blockRow)
+		{
+			Scalar first = 0;
+			Scalar second = 0;
+			for (auto k = A.blockRowBegin(blockRow); k < A.blockRowEnd(blockRow); ++k)
+			{
+				const Scalar* values = A.block(k);
+				const int j = 2 * A.blockCol(k);
+
+				first += values[0] * in[j] + values[1] * in[j + 1];
+				second += values[2] * in[j] + values[3] * in[j + 1];
+			}
+
+			const int i = 2 * blockRow;
+			out[i] = accumulate ? alpha * first + beta * out[i] : alpha * first;
+			out[i + 1] = accumulate ? alpha * second + beta * out[i + 1] : alpha * second;
+		}
+	}
+
+	/**
+	 * Multiplication : Matrice creuse par blocs * Vecteur
+	 */
+	template <typename Scalar>
+	Vector<Scalar, Dynamic> operator*(const BlockSparseMatrix<Scalar>& matrix, const Vector<Scalar, Dynamic>& vector)
+	{
+		Vector<Scalar, Dynamic> result(matrix.rows());
+		gemv(static_cast<Scalar>(1), matrix, vector, static_cast<Scalar>(0), result);
+		return result;
+	}
+
+	/**
+	 * Multiplication : Matrice diagonale * Vecteur
+	 */
+	template <typename Scalar, int Size, EnableIfFixedSize<Size> = 0>
+	Vector<Scalar, Size> operator*(const DiagonalMatrix<Scalar, Size>& matrix, const Vector<Scalar, Size>& vector)
+	{
+		ASSERT(vector.size() == matrix.cols(), "Trying to multiply a vector with a matrix of invalid size");
+
+		Vector<Scalar, Size> result(vector.size());
+		for (auto i = 0; i < vector.size(); ++i)
+		{
+			result(i) = matrix(i) * vector(i);
+		}
+
+		return result;
+	}
+
+	/*
+	 * Opérateurs paresseux pour les vecteurs et les matrices de taille dynamique.
+	 *
+	 * Ces opérateurs retournent une expression (voir Expressions.h) qui n'est
+	 * évaluée qu'à l'affectation : `x = x + dt * v` se fait en une seule boucle,
+	 * sans vecteur temporaire.
+	 */
+
+	template <typename Left, typename Right>
+	using EnableIfVectorOperands = typename std::enable_if<
+		IsVectorOperand<typename std::decay<Left>::type>::value && IsVectorOperand<typename std::decay<Right>::type>::value, int>::type;
+
+	template <typename Left, typename Right>
+	using EnableIfMatrixOperands = typename std::enable_if<
+		IsMatrixOperand<typename std::decay<Left>::type>::value && IsMatrixOperand<typename std::decay<Right>::type>::value, int>::type;
+
+	template <typename Scalar, typename Operand, template <typename> class IsOperand>
+	using EnableIfScaled = typename std::enable_if<
+		std::is_arithmetic<Scalar>::value && IsOperand<typename std::decay<Operand>::type>::value, int>::type;
+
+	/**
+	 * Addition : Vecteur + Vecteur
+	 */
+	template <typename Left, typename Right, EnableIfVectorOperands<Left, Right> = 0>
+	VectorBinaryExpression<ExpressionOperand<Left>, ExpressionOperand<Right>, AddOperation> operator+(Left&& left, Right&& right)
+	{
+		return VectorBinaryExpression<ExpressionOperand<Left>, ExpressionOperand<Right>, AddOperation>(std::forward<Left>(left), std::forward<Right>(right));
+	}
+
+	/**
+	 * Soustraction : Vecteur - Vecteur
+	 */
+	template <typename Left, typename Right, EnableIfVectorOperands<Left, Right> = 0>
+	VectorBinaryExpression<ExpressionOperand<Left>, ExpressionOperand<Right>, SubtractOperation> operator-(Left&& left, Right&& right)
+	{
+		return VectorBinaryExpression<ExpressionOperand<Left>, ExpressionOperand<Right>, SubtractOperation>(std::forward<Left>(left), std::forward<Right>(right));
+	}
+
+	/**
+	 * Multiplication : Scalaire * Vecteur
+	 */
+	template <typename Scalar, typename Operand, EnableIfScaled<Scalar, Operand, IsVectorOperand> = 0>
+	ScaledVectorExpression<ExpressionOperand<Operand>> operator*(const Scalar& scalar, Operand&& vector)
+	{
+		return ScaledVectorExpression<ExpressionOperand<Operand>>(scalar, std::forward<Operand>(vector));
+	}
+
+	/**
+	 * Multiplication : Vecteur * Scalaire
+	 */
+	template <typename Scalar, typename Operand, EnableIfScaled<Scalar, Operand, IsVectorOperand> = 0>
+	ScaledVectorExpression<ExpressionOperand<Operand>> operator*(Operand&& vector, const Scalar& scalar)
+	{
+		return ScaledVectorExpression<ExpressionOperand<Operand>>(scalar, std::forward<Operand>(vector));
+	}
+
+	/**
+	 * Multiplication d'un vecteur par -1
+	 */
+	template <typename Operand, typename std::enable_if<IsVectorOperand<typename std::decay<Operand>::type>::value, int>::type = 0>
+	ScaledVectorExpression<ExpressionOperand<Operand>> operator-(Operand&& vector)
+	{
+		return ScaledVectorExpression<ExpressionOperand<Operand>>(-1, std::forward<Operand>(vector));
+	}
+
+	/**
+	 * Multiplication : Matrice diagonale * Vecteur
+	 */
+	template <typename Diagonal, typename Operand, typename std::enable_if<
+		IsDynamicDiagonal<typename std::decay<Diagonal>::type>::value && IsVectorOperand<typename std::decay<Operand>::type>::value, int>::type = 0>
+	VectorBinaryExpression<DiagonalOperand<Diagonal>, ExpressionOperand<Operand>, MultiplyOperation> operator*(Diagonal&& matrix, Operand&& vector)
+	{
+		return VectorBinaryExpression<DiagonalOperand<Diagonal>, ExpressionOperand<Operand>, MultiplyOperation>(std::forward<Diagonal>(matrix).diagonal(), std::forward<Operand>(vector));
+	}
+
+	/**
+	 * Addition : Matrix + Matrix
+	 */
+	template <typename Left, typename Right, EnableIfMatrixOperands<Left, Right> = 0>
+	MatrixBinaryExpression<ExpressionOperand<Left>, ExpressionOperand<Right>, AddOperation> operator+(Left&& left, Right&& right)
+	{
+		return MatrixBinaryExpression<ExpressionOperand<Left>, ExpressionOperand<Right>, AddOperation>(std::forward<Left>(left), std::forward<Right>(right));
+	}
+
+	/**
+	 * Soustraction : Matrix - Matrix
+	 */
+	template <typename Left, typename Right, EnableIfMatrixOperands<Left, Right> = 0>
+	MatrixBinaryExpression<ExpressionOperand<Left>, ExpressionOperand<Right>, SubtractOperation> operator-(Left&& left, Right&& right)
+	{
+		return MatrixBinaryExpression<ExpressionOperand<Left>, ExpressionOperand<Right>, SubtractOperation>(std::forward<Left>(left), std::forward<Right>(right));
+	}
+
+	/**
+	 * Multiplication : Scalaire * Matrix
+	 */
+	template <typename Scalar, typename Operand, EnableIfScaled<Scalar, Operand, IsMatrixOperand> = 0>
+	ScaledMatrixExpression<ExpressionOperand<Operand>> operator*(const Scalar& scalar, Operand&& matrix)
+	{
+		return ScaledMatrixExpression<ExpressionOperand<Operand>>(scalar, std::forward<Operand>(matrix));
+	}
+
+	/**
+	 * Multiplication : Matrix * Scalaire
+	 */
+	template <typename Scalar, typename Operand, EnableIfScaled<Scalar, Operand, IsMatrixOperand> = 0>
+	ScaledMatrixExpression<ExpressionOperand<Operand>> operator*(Operand&& matrix, const Scalar& scalar)
+	{
+		return ScaledMatrixExpression<ExpressionOperand<Operand>>(scalar, std::forward<Operand>(matrix));
+	}
+
+	/**
+	 * Multiplication d'une matrice par -1
+	 */
+	template <typename Operand, typename std::enable_if<IsMatrixOperand<typename std::decay<Operand>::type>::value, int>::type = 0>
+	ScaledMatrixExpression<ExpressionOperand<Operand>> operator-(Operand&& matrix)
+	{
+		return ScaledMatrixExpression<ExpressionOperand<Operand>>(-1, std::forward<Operand>(matrix));
+	}
+
+	/**
+	 * Multiplication : Scalaire * Matrice creuse par blocs
+	 *
+	 * L'expression partage la structure de la matrice d'origine.
+	 */
+	template <typename Scalar, typename Operand, EnableIfScaled<Scalar, Operand, IsBlockSparseOperand> = 0>
+	auto operator*(const Scalar& scalar, Operand&& matrix)
+	{
+		return makeScaledBlockSparse(scalar, std::forward<Operand>(matrix));
+	}
+
+	/**
+	 * Addition : Matrice diagonale + Matrice creuse par blocs
+	 *
+	 * Puisque les blocs diagonaux font toujours partie de la structure d'une
+	 * matrice creuse par blocs, le résultat partage la structure de celle-ci.
+	 * Affecté à une matrice de même structure, `M - h * h * K` ne fait donc
+	 * aucune allocation.
+	 */
+	template <typename Diagonal, typename Sparse, typename std::enable_if<
+		IsDynamicDiagonal<typename std::decay<Diagonal>::type>::value && IsBlockSparseOperand<typename std::decay<Sparse>::type>::value, int>::type = 0>
+	auto operator+(Diagonal&& left, Sparse&& right)
+	{
+		auto sparse = makeScaledBlockSparse(1, std::forward<Sparse>(right));
+		return DiagonalBlockSparseSumExpression<DiagonalOperand<Diagonal>, decltype(sparse)>(std::forward<Diagonal>(left).diagonal(), std::move(sparse));
+	}
+
+	/**
+	 * Soustraction : Matrice diagonale - Matrice creuse par blocs
+	 *
+	 * Le résultat partage la structure de la matrice creuse.
+	 */
+	template <typename Diagonal, typename Sparse, typename std::enable_if<
+		IsDynamicDiagonal<typename std::decay<Diagonal>::type>::value && IsBlockSparseOperand<typename std::decay<Sparse>::type>::value, int>::type = 0>
+	auto operator-(Diagonal&& left, Sparse&& right)
+	{
+		auto sparse = makeScaledBlockSparse(-1, std::forward<Sparse>(right));
+		return DiagonalBlockSparseSumExpression<DiagonalOperand<Diagonal>, decltype(sparse)>(std::forward<Diagonal>(left).diagonal(), std::move(sparse));
+	}
 }
@@ -0,0 +1,373 @@
+#pragma once
+
+/**
+ * @file Simd.h
+ *
+ * @brief Noyaux vectorisés (SIMD) pour les opérations de base sur des tampons
+ *        de scalaires : produit scalaire, norme, axpy, mise à l'échelle,
+ *        addition et soustraction. Les paquets définis ici servent aussi au
+ *        micro-noyau du produit matriciel (voir Gemm.h).
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#endif
+
+namespace gti320
+{
+	namespace simd
+	{
+		/*
+		 * Le jeu d'instructions est choisi à la compilation (voir l'option
+		 * GTI320_SIMD du CMakeLists.txt de labo-1) : AVX-512, AVX2, puis SSE2.
+		 * Les noyaux sont écrits une seule fois pour un « paquet » de doubles
+		 * dont la largeur dépend du jeu d'instructions. Les autres types de
+		 * scalaires, ou une architecture sans SIMD, utilisent les boucles
+		 * scalaires.
+		 *
+		 * Les tampons de DenseStorage sont alignés sur 64 octets (une ligne de
+		 * cache et la largeur d'un registre AVX-512). Les noyaux acceptent
+		 * cependant des pointeurs quelconques (un bloc d'une matrice, par
+		 * exemple) et utilisent donc des chargements non alignés, sans coût sur
+		 * une adresse alignée.
+		 */
+#if defined(__AVX512F__)
+#define GTI320_SIMD_DOUBLE 1
+		struct DoublePacket
+		{
+			typedef __m512d Type;
+			static constexpr int Width = 8;
+
+			static inline Type zero() { return _mm512_setzero_pd(); }
+			static inline Type set(double value) { return _mm512_set1_pd(value); }
+			static inline Type load(const double* data) { return _mm512_loadu_pd(data); }
+			static inline void store(double* data, Type value) { _mm512_storeu_pd(data, value); }
+			static inline Type add(Type left, Type right) { return _mm512_add_pd(left, right); }
+			static inline Type subtract(Type left, Type right) { return _mm512_sub_pd(left, right); }
+			static inline Type multiply(Type left, Type right) { return _mm512_mul_pd(left, right); }
+			static inline Type divide(Type left, Type right) { return _mm512_div_pd(left, right); }
+			static inline Type squareRoot(Type value) { return _mm512_sqrt_pd(value); }
+			static inline Type multiplyAdd(Type left, Type right, Type accumulator) { return _mm512_fmadd_pd(left, right, accumulator); }
+			static inline double sum(Type value) { return _mm512_reduce_add_pd(value); }
+		};
+
+#define GTI320_SIMD_FLOAT 1
+		struct FloatPacket
+		{
+			typedef __m512 Type;
+			static constexpr int Width = 16;
+
+			static inline Type zero() { return _mm512_setzero_ps(); }
+			static inline Type set(float value) { return _mm512_set1_ps(value); }
+			static inline Type load(const float* data) { return _mm512_loadu_ps(data); }
+			static inline void store(float* data, Type value) { _mm512_storeu_ps(data, value); }
+			static inline Type add(Type left, Type right) { return _mm512_add_ps(left, right); }
+			static inline Type multiply(Type left, Type right) { return _mm512_mul_ps(left, right); }
+			static inline Type multiplyAdd(Type left, Type right, Type accumulator) { return _mm512_fmadd_ps(left, right, accumulator); }
+		};
+#elif defined(__AVX2__)
+#define GTI320_SIMD_DOUBLE 1
+		struct DoublePacket
+		{
+			typedef __m256d Type;
+			static constexpr int Width = 4;
+
+			static inline Type zero() { return _mm256_setzero_pd(); }
+			static inline Type set(double value) { return _mm256_set1_pd(value); }
+			static inline Type load(const double* data) { return _mm256_loadu_pd(data); }
+			static inline void store(double* data, Type value) { _mm256_storeu_pd(data, value); }
+			static inline Type add(Type left, Type right) { return _mm256_add_pd(left, right); }
+			static inline Type subtract(Type left, Type right) { return _mm256_sub_pd(left, right); }
+			static inline Type multiply(Type left, Type right) { return _mm256_mul_pd(left, right); }
+			static inline Type divide(Type left, Type right) { return _mm256_div_pd(left, right); }
+			static inline Type squareRoot(Type value) { return _mm256_sqrt_pd(value); }
+#if defined(__FMA__) || defined(_MSC_VER)
+			static inline Type multiplyAdd(Type left, Type right, Type accumulator) { return _mm256_fmadd_pd(left, right, accumulator); }
+#else
+			static inline Type multiplyAdd(Type left, Type right, Type accumulator) { return _mm256_add_pd(_mm256_mul_pd(left, right), accumulator); }
+#endif
+			static inline double sum(Type value)
+			{
+				const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+				return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+			}
+		};
+
+#define GTI320_SIMD_FLOAT 1
+		struct FloatPacket
+		{
+			typedef __m256 Type;
+			static constexpr int Width = 8;
+
+			static inline Type zero() { return _mm256_setzero_ps(); }
+			static inline Type set(float value) { return _mm256_set1_ps(value); }
+			static inline Type load(const float* data) { return _mm256_loadu_ps(data); }
+			static inline void store(float* data, Type value) { _mm256_storeu_ps(data, value); }
+			static inline Type add(Type left, Type right) { return _mm256_add_ps(left, right); }
+			static inline Type multiply(Type left, Type right) { return _mm256_mul_ps(left, right); }
+#if defined(__FMA__) || defined(_MSC_VER)
+			static inline Type multiplyAdd(Type left, Type right, Type accumulator) { return _mm256_fmadd_ps(left, right, accumulator); }
+#else
+			static inline Type multiplyAdd(Type left, Type right, Type accumulator) { return _mm256_add_ps(_mm256_mul_ps(left, right), accumulator); }
+#endif
+		};
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GTI320_SIMD_DOUBLE 1
+		struct DoublePacket
+		{
+			typedef __m128d Type;
+			static constexpr int Width = 2;
+
+			static inline Type zero() { return _mm_setzero_pd(); }
+			static inline Type set(double value) { return _mm_set1_pd(value); }
+			static inline Type load(const double* data) { return _mm_loadu_pd(data); }
+			static inline void store(double* data, Type value) { _mm_storeu_pd(data, value); }
+			static inline Type add(Type left, Type right) { return _mm_add_pd(left, right); }
+			static inline Type subtract(Type left, Type right) { return _mm_sub_pd(left, right); }
+			static inline Type multiply(Type left, Type right) { return _mm_mul_pd(left, right); }
+			static inline Type divide(Type left, Type right) { return _mm_div_pd(left, right); }
+			static inline Type squareRoot(Type value) { return _mm_sqrt_pd(value); }
+			static inline Type multiplyAdd(Type left, Type right, Type accumulator) { return _mm_add_pd(_mm_mul_pd(left, right), accumulator); }
+			static inline double sum(Type value) { return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value))); }
+		};
+
+#define GTI320_SIMD_FLOAT 1
+		struct FloatPacket
+		{
+			typedef __m128 Type;
+			static constexpr int Width = 4;
+
+			static inline Type zero() { return _mm_setzero_ps(); }
+			static inline Type set(float value) { return _mm_set1_ps(value); }
+			static inline Type load(const float* data) { return _mm_loadu_ps(data); }
+			static inline void store(float* data, Type value) { _mm_storeu_ps(data, value); }
+			static inline Type add(Type left, Type right) { return _mm_add_ps(left, right); }
+			static inline Type multiply(Type left, Type right) { return _mm_mul_ps(left, right); }
+			static inline Type multiplyAdd(Type left, Type right, Type accumulator) { return _mm_add_ps(_mm_mul_ps(left, right), accumulator); }
+		};
+#endif
+
+		/**
+		 * « Paquet » d'un seul scalaire, pour les types (ou les architectures)
+		 * sans instructions vectorielles.
+		 */
+		template <typename Scalar>
+		struct ScalarPacket
+		{
+			typedef Scalar Type;
+			static constexpr int Width = 1;
+
+			static inline Type zero() { return static_cast<Scalar>(0); }
+			static inline Type set(Scalar value) { return value; }
+			static inline Type load(const Scalar* data) { return *data; }
+			static inline void store(Scalar* data, Type value) { *data = value; }
+			static inline Type add(Type left, Type right) { return left + right; }
+			static inline Type subtract(Type left, Type right) { return left - right; }
+			static inline Type multiply(Type left, Type right) { return left * right; }
+			static inline Type divide(Type left, Type right) { return left / right; }
+			static inline Type squareRoot(Type value) { return std::sqrt(value); }
+			static inline Type multiplyAdd(Type left, Type right, Type accumulator) { return left * right + accumulator; }
+		};
+
+		/**
+		 * Paquet le plus large disponible pour un type de scalaire
+		 */
+		template <typename Scalar>
+		struct PacketOf
+		{
+			typedef ScalarPacket<Scalar> Type;
+		};
+
+#if defined(GTI320_SIMD_DOUBLE)
+		template <>
+		struct PacketOf<double>
+		{
+			typedef DoublePacket Type;
+		};
+#endif
+
+#if defined(GTI320_SIMD_FLOAT)
+		template <>
+		struct PacketOf<float>
+		{
+			typedef FloatPacket Type;
+		};
+#endif
+
+		/**
+		 * Produit scalaire de deux tampons de taille `size`
+		 */
+		template <typename Scalar>
+		inline Scalar dot(const Scalar* left, const Scalar* right, int size)
+		{
+			Scalar result = 0;
+			for (auto i = 0; i < size; ++i)
+			{
+				result += left[i] * right[i];
+			}
+			return result;
+		}
+
+		/**
+		 * Somme des carrés des éléments d'un tampon
+		 */
+		template <typename Scalar>
+		inline Scalar squaredNorm(const Scalar* data, int size)
+		{
+			return dot(data, data, size);
+		}
+
+		/**
+		 * y <- alpha * x + y
+		 */
+		template <typename Scalar>
+		inline void axpy(Scalar alpha, const Scalar* x, Scalar* y, int size)
+		{
+			for (auto i = 0; i < size; ++i)
+			{
+				y[i] += alpha * x[i];
+			}
+		}
+
+		/**
+		 * x <- alpha * x
+		 */
+		template <typename Scalar>
+		inline void scale(Scalar alpha, Scalar* x, int size)
+		{
+			for (auto i = 0; i < size; ++i)
+			{
+				x[i] *= alpha;
+			}
+		}
+
+		/**
+		 * out <- left + right (`out` peut être l'un des opérandes)
+		 */
+		template <typename Scalar>
+		inline void add(const Scalar* left, const Scalar* right, Scalar* out, int size)
+		{
+			for (auto i = 0; i < size; ++i)
+			{
+				out[i] = left[i] + right[i];
+			}
+		}
+
+		/**
+		 * out <- left - right (`out` peut être l'un des opérandes)
+		 */
+		template <typename Scalar>
+		inline void subtract(const Scalar* left, const Scalar* right, Scalar* out, int size)
+		{
+			for (auto i = 0; i < size; ++i)
+			{
+				out[i] = left[i] - right[i];
+			}
+		}
+
+#if defined(GTI320_SIMD_DOUBLE)
+		/*
+		 * Spécialisations pour les doubles. Les réductions utilisent deux
+		 * accumulateurs afin de masquer la latence des additions; l'ordre des
+		 * additions diffère donc légèrement de la boucle scalaire.
+		 */
+		inline double dot(const double* left, const double* right, int size)
+		{
+			typedef DoublePacket P;
+
+			P::Type first = P::zero();
+			P::Type second = P::zero();
+			auto i = 0;
+			for (; i + 2 * P::Width <= size; i += 2 * P::Width)
+			{
+				first = P::multiplyAdd(P::load(left + i), P::load(right + i), first);
+				second = P::multiplyAdd(P::load(left + i + P::Width), P::load(right + i + P::Width), second);
+			}
+			for (; i + P::Width <= size; i += P::Width)
+			{
+				first = P::multiplyAdd(P::load(left + i), P::load(right + i), first);
+			}
+
+			double result = P::sum(P::add(first, second));
+			for (; i < size; ++i)
+			{
+				result += left[i] * right[i];
+			}
+			return result;
+		}
+
+		inline double squaredNorm(const double* data, int size)
+		{
+			return dot(data, data, size);
+		}
+
+		inline void axpy(double alpha, const double* x, double* y, int size)
+		{
+			typedef DoublePacket P;
+
+			const P::Type packedAlpha = P::set(alpha);
+			auto i = 0;
+			for (; i + P::Width <= size; i += P::Width)
+			{
+				P::store(y + i, P::multiplyAdd(packedAlpha, P::load(x + i), P::load(y + i)));
+			}
+			for (; i < size; ++i)
+			{
+				y[i] += alpha * x[i];
+			}
+		}
+
+		inline void scale(double alpha, double* x, int size)
+		{
+			typedef DoublePacket P;
+
+			const P::Type packedAlpha = P::set(alpha);
+			auto i = 0;
+			for (; i + P::Width <= size; i += P::Width)
+			{
+				P::store(x + i, P::multiply(packedAlpha, P::load(x + i)));
+			}
+			for (; i < size; ++i)
+			{
+				x[i] *= alpha;
+			}
+		}
+
+		inline void add(const double* left, const double* right, double* out, int size)
+		{
+			typedef DoublePacket P;
+
+			auto i = 0;
+			for (; i + P::Width <= size; i += P::Width)
+			{
+				P::store(out + i, P::add(P::load(left + i), P::load(right + i)));
+			}
+			for (; i < size; ++i)
+			{
+				out[i] = left[i] + right[i];
+			}
+		}
+
+		inline void subtract(const double* left, const double* right, double* out, int size)
+		{
+			typedef DoublePacket P;
+
+			auto i = 0;
+			for (; i + P::Width <= size; i += P::Width)
+			{
+				P::store(out + i, P::subtract(P::load(left + i), P::load(right + i)));
+			}
+			for (; i < size; ++i)
+			{
+				out[i] = left[i] - right[i];
+			}
+		}
+#endif
+	}
+}
@@ -11,8 +11,12 @@
  */
 
 #include <cmath>
+#include <utility>
+
 #include "MatrixBase.h"
+#include "Expressions.h"
 #include "GTIAssert.h"
+#include "Simd.h"
 
 namespace gti320
 {
@@ -69,6 +73,13 @@ namespace gti320
 		{
 		}
 
+		/**
+		 * Constructeur de déplacement
+		 */
+		Vector(Vector&& other) : MatrixBase<Scalar, Rows, 1>(std::move(other))
+		{
+		}
+
 		/**
 		 * Destructeur
 		 */
@@ -117,6 +128,35 @@ namespace gti320
 			return *this;
 		}
 
+		/**
+		 * Opérateur de déplacement
+		 */
+		Vector& operator=(Vector&& other)
+		{
+			MatrixBase<Scalar, Rows, 1>::operator=(std::move(other));
+			return *this;
+		}
+
+		/**
+		 * Constructeur à partir d'une expression (voir Expressions.h)
+		 */
+		template <typename Expression>
+		Vector(const VectorExpression<Expression>& expression) : MatrixBase<Scalar, Rows, 1>()
+		{
+			assignExpression(expression.derived());
+		}
+
+		/**
+		 * Évalue une expression dans le vecteur en une seule boucle, sans vecteur
+		 * temporaire. Le vecteur n'est réalloué que si sa taille change.
+		 */
+		template <typename Expression>
+		Vector& operator=(const VectorExpression<Expression>& expression)
+		{
+			assignExpression(expression.derived());
+			return *this;
+		}
+
 		/**
 		 * Accesseur à une entrée du vecteur (lecture seule)
 		 */
@@ -141,6 +181,18 @@ namespace gti320
 			MatrixBase<Scalar, Rows, 1>::resize(rows, 1);
 		}
 
+		/**
+		 * Modifie le nombre de lignes du vecteur en conservant ses premiers
+		 * éléments. Les nouveaux éléments sont initialisés à zéro.
+		 */
+		void conservativeResize(int rows)
+		{
+			ASSERT(Rows == Dynamic || rows == Rows, "Attempting to resize a static vector. Use a dynamic vector instead.");
+
+			this->m_storage.conservativeResize(rows);
+			this->m_rows = rows;
+		}
+
 		/**
 		 * Produit scalaire de *this et other.
 		 */
@@ -148,13 +200,7 @@ namespace gti320
 		{
 			ASSERTF(this->size() == other.size(), "Attempting to compute the dot product of vectors of two different dimensions (%d and %d)", this->size(), other.size());
 
-			Scalar dotProduct = 0;
-			for (auto i = 0; i < this->size(); ++i)
-			{
-				dotProduct += (*this)(i) * other(i);
-			}
-
-			return dotProduct;
+			return simd::dot(this->data(), other.data(), this->size());
 		}
 
 		/**
@@ -170,13 +216,7 @@ namespace gti320
 		 */
 		inline Scalar squaredNorm() const
 		{
-			Scalar squaredNorm = 0;
-			for (auto i = 0; i < this->size(); ++i)
-			{
-				squaredNorm += (*this)(i) * (*this)(i);
-			}
-
-			return squaredNorm;
+			return simd::squaredNorm(this->data(), this->size());
 		}
 
 		// NOUVEAU_LABO2
@@ -215,5 +255,82 @@ namespace gti320
 		inline Scalar& z() { return (*this)(2); }
 		inline Scalar w() const { return (*this)(3); }
 		inline Scalar& w() { return (*this)(3); }
+
+	private:
+		/**
+		 * Évaluation d'une expression quelconque, élément par élément.
+		 */
+		template <typename Expression>
+		void assignExpression(const Expression& expression)
+		{
+			resizeForExpression(expression.size());
+
+			// Chaque élément ne dépend que des éléments de même indice des
+			// opérandes : le vecteur peut donc apparaître dans l'expression.
+			for (auto i = 0; i < this->size(); ++i)
+			{
+				this->m_storage[i] = expression(i);
+			}
+		}
+
+		/*
+		 * Les formes d'expressions les plus fréquentes dans les solveurs sont
+		 * évaluées directement par les noyaux vectorisés de Simd.h.
+		 */
+
+		// *this = a + b
+		void assignExpression(const VectorBinaryExpression<const Vector&, const Vector&, AddOperation>& expression)
+		{
+			resizeForExpression(expression.size());
+			simd::add(expression.left().data(), expression.right().data(), this->m_storage.data(), this->size());
+		}
+
+		// *this = a - b
+		void assignExpression(const VectorBinaryExpression<const Vector&, const Vector&, SubtractOperation>& expression)
+		{
+			resizeForExpression(expression.size());
+			simd::subtract(expression.left().data(), expression.right().data(), this->m_storage.data(), this->size());
+		}
+
+		// *this = *this + alpha * x (axpy)
+		void assignExpression(const VectorBinaryExpression<const Vector&, ScaledVectorExpression<const Vector&>, AddOperation>& expression)
+		{
+			if (&expression.left() != this || &expression.right().operand() == this)
+			{
+				assignExpression<>(expression);
+				return;
+			}
+			simd::axpy(expression.right().scalar(), expression.right().operand().data(), this->m_storage.data(), this->size());
+		}
+
+		// *this = *this - alpha * x (axpy)
+		void assignExpression(const VectorBinaryExpression<const Vector&, ScaledVectorExpression<const Vector&>, SubtractOperation>& expression)
+		{
+			if (&expression.left() != this || &expression.right().operand() == this)
+			{
+				assignExpression<>(expression);
+				return;
+			}
+			simd::axpy(-expression.right().scalar(), expression.right().operand().data(), this->m_storage.data(), this->size());
+		}
+
+		// *this = alpha * *this
+		void assignExpression(const ScaledVectorExpression<const Vector&>& expression)
+		{
+			if (&expression.operand() != this)
+			{
+				assignExpression<>(expression);
+				return;
+			}
+			simd::scale(expression.scalar(), this->m_storage.data(), this->size());
+		}
+
+		void resizeForExpression(int size)
+		{
+			if (size != this->size())
+			{
+				resize(size);
+			}
+		}
 	};
 }
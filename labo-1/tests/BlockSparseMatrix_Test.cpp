@@ -0,0 +1,149 @@
+/**
+ * @file BlockSparseMatrix_Test.cpp
+ *
+ * @brief Unit tests for the BlockSparseMatrix class.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "../BlockSparseMatrix.h"
+#include "../Operators.h"
+
+using namespace gti320;
+
+/*
+ * Teste que la structure contient les blocs demandés, sans doublons, et les blocs diagonaux
+ */
+TEST(TestBlockSparseMatrix, SetPattern_Ok)
+{
+	BlockSparseMatrix<double> matrix;
+	matrix.setPattern(3, { {0, 2}, {2, 0}, {0, 2} });
+
+	EXPECT_EQ(6, matrix.rows());
+	EXPECT_EQ(6, matrix.cols());
+	EXPECT_EQ(3, matrix.blockRows());
+	EXPECT_EQ(5, matrix.nonZeroBlocks());
+
+	EXPECT_EQ(0, matrix.blockRowBegin(0));
+	EXPECT_EQ(2, matrix.blockRowEnd(0));
+	EXPECT_EQ(0, matrix.blockCol(0));
+	EXPECT_EQ(2, matrix.blockCol(1));
+
+	for (auto i = 0; i < 3; ++i)
+	{
+		EXPECT_EQ(i, matrix.blockCol(matrix.diagonalBlock(i)));
+	}
+
+	EXPECT_EQ(1, matrix.findBlock(0, 2));
+	EXPECT_EQ(-1, matrix.findBlock(0, 1));
+	EXPECT_EQ(-1, matrix.findBlock(1, 2));
+}
+
+/*
+ * Teste que les valeurs des blocs sont accessibles par éléments et par conversion en matrice dense
+ */
+TEST(TestBlockSparseMatrix, ElementAccessAndToDense_Ok)
+{
+	BlockSparseMatrix<double> matrix;
+	matrix.setPattern(2, { {0, 1} });
+
+	double* block = matrix.block(matrix.findBlock(0, 1));
+	block[0] = 1.0;
+	block[1] = 2.0;
+	block[2] = 3.0;
+	block[3] = 4.0;
+
+	EXPECT_DOUBLE_EQ(1.0, matrix(0, 2));
+	EXPECT_DOUBLE_EQ(2.0, matrix(0, 3));
+	EXPECT_DOUBLE_EQ(3.0, matrix(1, 2));
+	EXPECT_DOUBLE_EQ(4.0, matrix(1, 3));
+	EXPECT_DOUBLE_EQ(0.0, matrix(2, 0));
+
+	const auto dense = matrix.toDense();
+	for (auto i = 0; i < 4; ++i)
+	{
+		for (auto j = 0; j < 4; ++j)
+		{
+			EXPECT_DOUBLE_EQ(matrix(i, j), dense(i, j));
+		}
+	}
+}
+
+/*
+ * Teste que la multiplication matrice creuse * vecteur donne le même résultat que la version dense
+ */
+TEST(TestBlockSparseMatrix, Operator_Multiplication_Vector_Ok)
+{
+	BlockSparseMatrix<double> matrix;
+	matrix.setPattern(3, { {0, 1}, {1, 0}, {1, 2}, {2, 1} });
+
+	for (auto k = 0; k < matrix.nonZeroBlocks(); ++k)
+	{
+		for (auto j = 0; j < 4; ++j)
+		{
+			matrix.block(k)[j] = static_cast<double>(k * 4 + j + 1);
+		}
+	}
+
+	Vector<double, Dynamic> vector = { 1.0, -2.0, 3.0, -4.0, 5.0, -6.0 };
+
+	const auto sparseResult = matrix * vector;
+	const auto denseResult = matrix.toDense() * vector;
+
+	ASSERT_EQ(6, sparseResult.size());
+	for (auto i = 0; i < 6; ++i)
+	{
+		EXPECT_DOUBLE_EQ(denseResult(i), sparseResult(i));
+	}
+}
+
+/*
+ * Teste y = alpha * A * x + beta * y pour une matrice creuse par blocs
+ */
+TEST(TestBlockSparseMatrix, Gemv_Ok)
+{
+	BlockSparseMatrix<double> matrix;
+	matrix.setPattern(3, { {0, 2}, {2, 0}, {1, 2} });
+
+	for (auto k = 0; k < matrix.nonZeroBlocks(); ++k)
+	{
+		for (auto j = 0; j < 4; ++j)
+		{
+			matrix.block(k)[j] = static_cast<double>(k - j) * 0.5;
+		}
+	}
+
+	const Vector<double, Dynamic> vector = { 1.0, -2.0, 3.0, -4.0, 5.0, -6.0 };
+	const Vector<double, Dynamic> original = { 0.5, 1.0, 1.5, 2.0, 2.5, 3.0 };
+
+	auto result = original;
+	gemv(3.0, matrix, vector, 2.0, result);
+
+	const auto product = matrix.toDense() * vector;
+	for (auto i = 0; i < 6; ++i)
+	{
+		EXPECT_DOUBLE_EQ(3.0 * product(i) + 2.0 * original(i), result(i));
+	}
+}
+
+/*
+ * Teste que la multiplication par un scalaire conserve la structure et multiplie les valeurs
+ */
+TEST(TestBlockSparseMatrix, Operator_Multiplication_Scalar_Ok)
+{
+	BlockSparseMatrix<double> matrix;
+	matrix.setPattern(2, { {0, 1} });
+	matrix.block(0)[0] = 2.0;
+	matrix.block(1)[1] = -3.0;
+
+	const auto result = 2.0 * matrix;
+
+	EXPECT_TRUE(result.hasSamePattern(matrix));
+	EXPECT_DOUBLE_EQ(4.0, result(0, 0));
+	EXPECT_DOUBLE_EQ(-6.0, result(0, 3));
+	EXPECT_DOUBLE_EQ(2.0, matrix(0, 0));
+}
@@ -10,6 +10,8 @@
 
 #include <gtest/gtest.h>
 
+#include <utility>
+
 #include "../DenseStorage.h"
 
 using namespace gti320;
@@ -448,4 +450,126 @@ TEST(TestLabo1, DenseStorage_Dynamic_BracketOperator_Ok)
 	EXPECT_EQ(-60, denseStorage[4]);
 }
 
+/*
+ * Teste que le constructeur de déplacement du DenseStorage dynamique récupère le tampon sans copie
+ */
+TEST(TestLabo1, DenseStorage_Dynamic_MoveConstructor_Ok)
+{
+	DenseStorage<int, Dynamic> source{ 1, 4, 2 };
+	const int* data = source.data();
+
+	DenseStorage<int, Dynamic> denseStorage(std::move(source));
+
+	EXPECT_EQ(data, denseStorage.data());
+	EXPECT_EQ(3, denseStorage.size());
+	EXPECT_EQ(2, denseStorage[2]);
+
+	EXPECT_EQ(nullptr, source.data());
+	EXPECT_EQ(0, source.size());
+}
+
+/*
+ * Teste que l'opérateur de déplacement du DenseStorage dynamique récupère le tampon sans copie
+ */
+TEST(TestLabo1, DenseStorage_Dynamic_MoveOperator_Ok)
+{
+	DenseStorage<int, Dynamic> source{ 1, 4, 2 };
+	DenseStorage<int, Dynamic> denseStorage{ 7, 8 };
+	const int* data = source.data();
+
+	denseStorage = std::move(source);
+
+	EXPECT_EQ(data, denseStorage.data());
+	EXPECT_EQ(3, denseStorage.size());
+	EXPECT_EQ(4, denseStorage[1]);
+	EXPECT_EQ(0, source.size());
+}
+
+/*
+ * Teste que swap échange les tampons de deux DenseStorage dynamiques
+ */
+TEST(TestLabo1, DenseStorage_Dynamic_swap_Ok)
+{
+	DenseStorage<int, Dynamic> first{ 1, 4, 2 };
+	DenseStorage<int, Dynamic> second{ 7, 8 };
+	const int* firstData = first.data();
+	const int* secondData = second.data();
+
+	first.swap(second);
+
+	EXPECT_EQ(secondData, first.data());
+	EXPECT_EQ(firstData, second.data());
+	EXPECT_EQ(2, first.size());
+	EXPECT_EQ(3, second.size());
+	EXPECT_EQ(8, first[1]);
+	EXPECT_EQ(2, second[2]);
+}
+
+/*
+ * Teste que la méthode "resize" du DenseStorage ne réalloue pas le tampon si la capacité suffit
+ */
+TEST(TestLabo1, DenseStorage_Dynamic_resize_KeepsCapacity)
+{
+	DenseStorage<int, Dynamic> denseStorage = { 1, 2, 3, 4 };
+	const int* data = denseStorage.data();
+
+	denseStorage.resize(2);
+	EXPECT_EQ(2, denseStorage.size());
+	EXPECT_EQ(4, denseStorage.capacity());
+	EXPECT_EQ(data, denseStorage.data());
+
+	denseStorage.resize(4);
+	EXPECT_EQ(4, denseStorage.size());
+	EXPECT_EQ(data, denseStorage.data());
+
+	denseStorage.resize(6);
+	EXPECT_EQ(6, denseStorage.size());
+	EXPECT_EQ(6, denseStorage.capacity());
+}
+
+/*
+ * Teste que la méthode "reserve" du DenseStorage augmente la capacité sans modifier le contenu
+ */
+TEST(TestLabo1, DenseStorage_Dynamic_reserve_Ok)
+{
+	DenseStorage<int, Dynamic> denseStorage = { 1, 2, 3 };
+
+	denseStorage.reserve(10);
+	EXPECT_EQ(3, denseStorage.size());
+	EXPECT_EQ(10, denseStorage.capacity());
+	EXPECT_EQ(1, denseStorage[0]);
+	EXPECT_EQ(3, denseStorage[2]);
+
+	const int* data = denseStorage.data();
+	denseStorage.reserve(5);
+	denseStorage.resize(8);
+	EXPECT_EQ(10, denseStorage.capacity());
+	EXPECT_EQ(data, denseStorage.data());
+}
+
+/*
+ * Teste que la méthode "conservativeResize" du DenseStorage conserve les éléments existants
+ */
+TEST(TestLabo1, DenseStorage_Dynamic_conservativeResize_Ok)
+{
+	DenseStorage<int, Dynamic> denseStorage = { 1, 2, 3 };
+
+	denseStorage.conservativeResize(5);
+	EXPECT_EQ(5, denseStorage.size());
+	EXPECT_EQ(1, denseStorage[0]);
+	EXPECT_EQ(2, denseStorage[1]);
+	EXPECT_EQ(3, denseStorage[2]);
+	EXPECT_EQ(0, denseStorage[3]);
+	EXPECT_EQ(0, denseStorage[4]);
+
+	denseStorage.conservativeResize(2);
+	EXPECT_EQ(2, denseStorage.size());
+	EXPECT_EQ(2, denseStorage[1]);
+
+	denseStorage.conservativeResize(4);
+	EXPECT_EQ(2, denseStorage[1]);
+	EXPECT_EQ(0, denseStorage[2]);
+	EXPECT_EQ(0, denseStorage[3]);
+}
+
 #pragma endregion
\ No newline at end of file
@@ -0,0 +1,123 @@
+/**
+ * @file DiagonalMatrix_Test.cpp
+ *
+ * @brief Unit tests for the DiagonalMatrix class.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "../DiagonalMatrix.h"
+#include "../Operators.h"
+
+using namespace gti320;
+
+/*
+ * Teste que les éléments hors de la diagonale sont nuls et que la conversion en matrice dense est correcte
+ */
+TEST(TestDiagonalMatrix, ElementAccessAndToDense_Ok)
+{
+	DiagonalMatrix<double> matrix(3);
+	matrix(0) = 1.0;
+	matrix(1) = 2.0;
+	matrix(2) = 3.0;
+
+	EXPECT_EQ(3, matrix.rows());
+	EXPECT_EQ(3, matrix.cols());
+
+	const auto dense = matrix.toDense();
+	for (auto i = 0; i < 3; ++i)
+	{
+		for (auto j = 0; j < 3; ++j)
+		{
+			const double expected = i == j ? static_cast<double>(i + 1) : 0.0;
+			EXPECT_DOUBLE_EQ(expected, matrix(i, j));
+			EXPECT_DOUBLE_EQ(expected, dense(i, j));
+		}
+	}
+}
+
+/*
+ * Teste la multiplication matrice diagonale * vecteur
+ */
+TEST(TestDiagonalMatrix, Operator_Multiplication_Vector_Ok)
+{
+	DiagonalMatrix<double> matrix(Vector<double, Dynamic>{ 2.0, -1.0, 0.5 });
+	Vector<double, Dynamic> vector = { 3.0, 4.0, 8.0 };
+
+	const auto result = matrix * vector;
+
+	ASSERT_EQ(3, result.size());
+	EXPECT_DOUBLE_EQ(6.0, result(0));
+	EXPECT_DOUBLE_EQ(-4.0, result(1));
+	EXPECT_DOUBLE_EQ(4.0, result(2));
+}
+
+/*
+ * Teste l'addition et la soustraction d'une matrice diagonale et d'une matrice creuse par blocs
+ */
+TEST(TestDiagonalMatrix, Operator_AdditionSubstraction_BlockSparse_Ok)
+{
+	BlockSparseMatrix<double> sparse;
+	sparse.setPattern(2, { {0, 1}, {1, 0} });
+	for (auto k = 0; k < sparse.nonZeroBlocks(); ++k)
+	{
+		for (auto j = 0; j < 4; ++j)
+		{
+			sparse.block(k)[j] = static_cast<double>(k + j);
+		}
+	}
+
+	DiagonalMatrix<double> diagonal(Vector<double, Dynamic>{ 10.0, 20.0, 30.0, 40.0 });
+
+	const auto sum = diagonal + sparse;
+	const auto difference = diagonal - sparse;
+
+	EXPECT_TRUE(sum.hasSamePattern(sparse));
+	EXPECT_TRUE(difference.hasSamePattern(sparse));
+
+	for (auto i = 0; i < 4; ++i)
+	{
+		for (auto j = 0; j < 4; ++j)
+		{
+			EXPECT_DOUBLE_EQ(diagonal(i, j) + sparse(i, j), sum(i, j));
+			EXPECT_DOUBLE_EQ(diagonal(i, j) - sparse(i, j), difference(i, j));
+		}
+	}
+}
+
+/*
+ * Teste que l'affectation de M - s * K réutilise la structure et la mémoire de la destination
+ */
+TEST(TestDiagonalMatrix, Operator_Substraction_ScaledBlockSparse_ReusesStorage)
+{
+	BlockSparseMatrix<double> sparse;
+	sparse.setPattern(2, { {0, 1}, {1, 0} });
+	for (auto k = 0; k < sparse.nonZeroBlocks(); ++k)
+	{
+		for (auto j = 0; j < 4; ++j)
+		{
+			sparse.block(k)[j] = static_cast<double>(k + j);
+		}
+	}
+
+	DiagonalMatrix<double> diagonal(Vector<double, Dynamic>{ 10.0, 20.0, 30.0, 40.0 });
+
+	BlockSparseMatrix<double> result = diagonal - 0.5 * sparse;
+	EXPECT_TRUE(result.hasSamePattern(sparse));
+
+	const double* values = result.values().data();
+	result = diagonal - 2.0 * (0.5 * sparse);
+	EXPECT_EQ(values, result.values().data());
+
+	for (auto i = 0; i < 4; ++i)
+	{
+		for (auto j = 0; j < 4; ++j)
+		{
+			EXPECT_DOUBLE_EQ(diagonal(i, j) - sparse(i, j), result(i, j));
+		}
+	}
+}
@@ -0,0 +1,226 @@
+/**
+ * @file Gemm_Test.cpp
+ *
+ * @brief Unit tests for the blocked matrix product.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "../Gemm.h"
+#include "../Matrix.h"
+#include "../Operators.h"
+
+using namespace gti320;
+
+namespace
+{
+	template <typename Scalar, int Storage>
+	Matrix<Scalar, Dynamic, Dynamic, Storage> makeMatrix(int rows, int cols, int seed)
+	{
+		Matrix<Scalar, Dynamic, Dynamic, Storage> matrix(rows, cols);
+		for (auto i = 0; i < rows; ++i)
+		{
+			for (auto j = 0; j < cols; ++j)
+			{
+				matrix(i, j) = static_cast<Scalar>(((i * 7 + j * 13 + seed) % 19) - 9) / static_cast<Scalar>(8);
+			}
+		}
+		return matrix;
+	}
+
+	/**
+	 * Compare A * B à la triple boucle de référence
+	 */
+	template <typename Scalar, int StorageA, int StorageB>
+	void expectProductOk(int m, int n, int k, Scalar tolerance)
+	{
+		const auto left = makeMatrix<Scalar, StorageA>(m, k, 1);
+		const auto right = makeMatrix<Scalar, StorageB>(k, n, 5);
+
+		const Matrix<Scalar, Dynamic, Dynamic> result = left * right;
+		ASSERT_EQ(m, result.rows());
+		ASSERT_EQ(n, result.cols());
+
+		for (auto j = 0; j < n; ++j)
+		{
+			for (auto i = 0; i < m; ++i)
+			{
+				double expected = 0.0;
+				for (auto p = 0; p < k; ++p)
+				{
+					expected += static_cast<double>(left(i, p)) * static_cast<double>(right(p, j));
+				}
+				EXPECT_NEAR(expected, static_cast<double>(result(i, j)), tolerance * (1.0 + std::abs(expected)));
+			}
+		}
+	}
+}
+
+/*
+ * Teste le produit bloqué pour des tailles qui ne sont pas des multiples des
+ * tuiles du micro-noyau, avec toutes les combinaisons de stockage
+ */
+TEST(TestGemm, Gemm_Double_OddSizes_Ok)
+{
+	expectProductOk<double, ColumnStorage, ColumnStorage>(67, 45, 53, 1e-12);
+	expectProductOk<double, RowStorage, ColumnStorage>(67, 45, 53, 1e-12);
+	expectProductOk<double, ColumnStorage, RowStorage>(67, 45, 53, 1e-12);
+	expectProductOk<double, RowStorage, RowStorage>(67, 45, 53, 1e-12);
+}
+
+/*
+ * Teste le produit lorsque plusieurs blocs de A et de B sont nécessaires
+ */
+TEST(TestGemm, Gemm_Double_MultipleBlocks_Ok)
+{
+	expectProductOk<double, ColumnStorage, ColumnStorage>(401, 13, 517, 1e-12);
+	expectProductOk<double, RowStorage, RowStorage>(211, 9, 300, 1e-12);
+}
+
+/*
+ * Teste le produit en simple précision
+ */
+TEST(TestGemm, Gemm_Float_Ok)
+{
+	expectProductOk<float, ColumnStorage, ColumnStorage>(99, 70, 81, 1e-5f);
+	expectProductOk<float, RowStorage, ColumnStorage>(33, 260, 40, 1e-5f);
+}
+
+/*
+ * Teste le produit pour un type sans instructions vectorielles
+ */
+TEST(TestGemm, Gemm_Int_Ok)
+{
+	Matrix<int, Dynamic, Dynamic, ColumnStorage> left(50, 40);
+	Matrix<int, Dynamic, Dynamic, RowStorage> right(40, 30);
+	for (auto i = 0; i < 50; ++i)
+	{
+		for (auto j = 0; j < 40; ++j)
+		{
+			left(i, j) = (i + 2 * j) % 5 - 2;
+		}
+	}
+	for (auto i = 0; i < 40; ++i)
+	{
+		for (auto j = 0; j < 30; ++j)
+		{
+			right(i, j) = (3 * i + j) % 7 - 3;
+		}
+	}
+
+	const Matrix<int, Dynamic, Dynamic> result = left * right;
+	for (auto i = 0; i < 50; ++i)
+	{
+		for (auto j = 0; j < 30; ++j)
+		{
+			int expected = 0;
+			for (auto p = 0; p < 40; ++p)
+			{
+				expected += left(i, p) * right(p, j);
+			}
+			EXPECT_EQ(expected, result(i, j));
+		}
+	}
+}
+
+/*
+ * Teste que gemm accumule dans C et accepte des matrices vides
+ */
+TEST(TestGemm, Gemm_Accumulates_Ok)
+{
+	const double a[] = { 1.0, 2.0, 3.0, 4.0 };  // 2 x 2 par colonnes
+	const double b[] = { 1.0, 0.0, 0.0, 1.0 };  // identité
+	double c[] = { 10.0, 10.0, 10.0, 10.0 };
+
+	gemm(2, 2, 2, a, 1, 2, b, 1, 2, c, 1, 2);
+	EXPECT_DOUBLE_EQ(11.0, c[0]);
+	EXPECT_DOUBLE_EQ(12.0, c[1]);
+	EXPECT_DOUBLE_EQ(13.0, c[2]);
+	EXPECT_DOUBLE_EQ(14.0, c[3]);
+
+	gemm(2, 2, 0, a, 1, 2, b, 1, 2, c, 1, 2);
+	EXPECT_DOUBLE_EQ(11.0, c[0]);
+}
+
+/*
+ * Teste y = alpha * A * x + beta * y pour les deux types de stockage, avec
+ * des tailles qui couvrent les segments de lignes et l'exécution parallèle
+ */
+TEST(TestGemm, Gemv_Dense_Ok)
+{
+	const int sizes[][2] = { { 1, 1 }, { 7, 5 }, { 1030, 3 }, { 300, 301 } };
+	for (const auto& size : sizes)
+	{
+		const int m = size[0];
+		const int n = size[1];
+		const auto columnMatrix = makeMatrix<double, ColumnStorage>(m, n, 2);
+		const auto rowMatrix = makeMatrix<double, RowStorage>(m, n, 2);
+
+		Vector<double, Dynamic> x(n);
+		for (auto j = 0; j < n; ++j)
+		{
+			x(j) = 0.25 * j - 1.0;
+		}
+		Vector<double, Dynamic> original(m);
+		for (auto i = 0; i < m; ++i)
+		{
+			original(i) = 0.5 - 0.125 * i;
+		}
+
+		auto columnResult = original;
+		auto rowResult = original;
+		gemv(2.0, columnMatrix, x, -0.5, columnResult);
+		gemv(2.0, rowMatrix, x, -0.5, rowResult);
+
+		const Vector<double, Dynamic> product = rowMatrix * x;
+		ASSERT_EQ(m, product.size());
+
+		for (auto i = 0; i < m; ++i)
+		{
+			double expected = 0.0;
+			for (auto j = 0; j < n; ++j)
+			{
+				expected += columnMatrix(i, j) * x(j);
+			}
+			EXPECT_NEAR(expected, product(i), 1e-12 * (1.0 + std::abs(expected)));
+
+			expected = 2.0 * expected - 0.5 * original(i);
+			EXPECT_NEAR(expected, columnResult(i), 1e-12 * (1.0 + std::abs(expected)));
+			EXPECT_NEAR(expected, rowResult(i), 1e-12 * (1.0 + std::abs(expected)));
+		}
+	}
+}
+
+/*
+ * Teste que y n'est pas lu lorsque beta est nul et qu'il est alors
+ * redimensionné au besoin
+ */
+TEST(TestGemm, Gemv_ZeroBeta_IgnoresOutput)
+{
+	const auto matrix = makeMatrix<double, ColumnStorage>(6, 4, 3);
+	const Vector<double, Dynamic> x{ 1.0, 2.0, 3.0, 4.0 };
+
+	Vector<double, Dynamic> y(6);
+	for (auto i = 0; i < 6; ++i)
+	{
+		y(i) = std::nan("");
+	}
+	gemv(1.0, matrix, x, 0.0, y);
+
+	Vector<double, Dynamic> resized(2);
+	gemv(1.0, matrix, x, 0.0, resized);
+	ASSERT_EQ(6, resized.size());
+
+	const Vector<double, Dynamic> expected = matrix * x;
+	for (auto i = 0; i < 6; ++i)
+	{
+		EXPECT_DOUBLE_EQ(expected(i), y(i));
+		EXPECT_DOUBLE_EQ(expected(i), resized(i));
+	}
+}
@@ -0,0 +1,196 @@
+/**
+ * @file Map_Test.cpp
+ *
+ * @brief Unit tests for the Map and view classes.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <utility>
+
+#include "../Map.h"
+#include "../Matrix.h"
+#include "../Operators.h"
+#include "../Vector.h"
+
+using namespace gti320;
+
+/*
+ * Teste qu'un Map lit et écrit directement dans la mémoire externe
+ */
+TEST(TestMap, Map_Vector_ReadWrite_Ok)
+{
+	double data[] = { 1.0, 2.0, 3.0, 4.0 };
+	Map<Vector<double, Dynamic>> map(data, 4);
+
+	EXPECT_EQ(4, map.size());
+	EXPECT_EQ(data, map.data());
+	EXPECT_DOUBLE_EQ(3.0, map(2));
+
+	map(1) = -2.0;
+	EXPECT_DOUBLE_EQ(-2.0, data[1]);
+
+	const Vector<double, Dynamic> other = { 5.0, 6.0, 7.0, 8.0 };
+	map = other;
+	EXPECT_EQ(data, map.data());
+	EXPECT_DOUBLE_EQ(8.0, data[3]);
+
+	// Une copie du Map référence la même mémoire; une copie en vecteur non
+	Map<Vector<double, Dynamic>> alias(map);
+	alias(0) = 10.0;
+	EXPECT_DOUBLE_EQ(10.0, data[0]);
+
+	Vector<double, Dynamic> copy = map;
+	copy(0) = 0.0;
+	EXPECT_DOUBLE_EQ(10.0, data[0]);
+
+	Vector<double, Dynamic> moved = std::move(alias);
+	EXPECT_NE(data, moved.data());
+	EXPECT_DOUBLE_EQ(10.0, moved(0));
+}
+
+/*
+ * Teste les Map dans les expressions et les noyaux vectorisés
+ */
+TEST(TestMap, Map_Vector_Expressions_Ok)
+{
+	double xData[] = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+	double vData[] = { 0.5, 0.5, -1.0, 2.0, 0.0 };
+	Map<Vector<double, Dynamic>> x(xData, 5);
+	const Map<const Vector<double, Dynamic>> v(vData, 5);
+
+	x = x + 2.0 * v;
+	EXPECT_DOUBLE_EQ(2.0, xData[0]);
+	EXPECT_DOUBLE_EQ(1.0, xData[2]);
+	EXPECT_DOUBLE_EQ(8.0, xData[3]);
+
+	const Vector<double, Dynamic> sum = x + v;
+	EXPECT_DOUBLE_EQ(2.5, sum(0));
+	EXPECT_DOUBLE_EQ(2.0 * 0.5 + 3.0 * 0.5 + 1.0 * -1.0 + 8.0 * 2.0, x.dot(v));
+}
+
+/*
+ * Teste l'échange entre un Map et un vecteur : la mémoire externe reste
+ * attachée au Map
+ */
+TEST(TestMap, Map_Vector_Swap_Ok)
+{
+	double data[] = { 1.0, 2.0 };
+	Map<Vector<double, Dynamic>> map(data, 2);
+	Vector<double, Dynamic> vector = { 3.0, 4.0 };
+
+	map.swap(vector);
+	EXPECT_EQ(data, map.data());
+	EXPECT_DOUBLE_EQ(3.0, data[0]);
+	EXPECT_DOUBLE_EQ(4.0, data[1]);
+	EXPECT_DOUBLE_EQ(1.0, vector(0));
+	EXPECT_DOUBLE_EQ(2.0, vector(1));
+}
+
+/*
+ * Teste qu'un Map refuse de changer de taille, même en mode release : la
+ * mémoire externe ne peut être ni agrandie ni réduite
+ */
+TEST(TestMap, Map_Vector_Resize_Death)
+{
+	double data[] = { 1.0, 2.0 };
+	Map<Vector<double, Dynamic>> map(data, 2);
+
+	map.resize(2);
+	EXPECT_EQ(data, map.data());
+
+	EXPECT_DEATH(map.resize(4), "mapped dense storage");
+	EXPECT_DEATH(map.resize(1), "mapped dense storage");
+
+	Vector<double, Dynamic> vector = { 3.0, 4.0, 5.0 };
+	EXPECT_DEATH(map.swap(vector), "different size");
+}
+
+/*
+ * Teste un Map sur une matrice et les produits qui l'utilisent
+ */
+TEST(TestMap, Map_Matrix_Ok)
+{
+	double data[] = { 1.0, 3.0, 2.0, 4.0 }; // [1 2; 3 4] par colonnes
+	Map<Matrix<double, Dynamic, Dynamic, ColumnStorage>> matrix(data, 2, 2);
+
+	EXPECT_DOUBLE_EQ(2.0, matrix(0, 1));
+	EXPECT_DOUBLE_EQ(3.0, matrix(1, 0));
+
+	double xData[] = { 1.0, -1.0 };
+	Map<Vector<double, Dynamic>> x(xData, 2);
+	const Vector<double, Dynamic> product = matrix * x;
+	EXPECT_DOUBLE_EQ(-1.0, product(0));
+	EXPECT_DOUBLE_EQ(-1.0, product(1));
+
+	double yData[] = { 1.0, 1.0 };
+	Map<Vector<double, Dynamic>> y(yData, 2);
+	gemv(2.0, matrix, x, 1.0, y);
+	EXPECT_DOUBLE_EQ(-1.0, yData[0]);
+	EXPECT_DOUBLE_EQ(-1.0, yData[1]);
+
+	matrix = 2.0 * matrix;
+	EXPECT_DOUBLE_EQ(8.0, data[3]);
+}
+
+/*
+ * Teste une vue avec un pas : les coordonnées x et y de points entrelacés
+ */
+TEST(TestMap, VectorView_Stride_Ok)
+{
+	double points[] = { 1.0, 10.0, 2.0, 20.0, 3.0, 30.0 };
+	VectorView<double> xs(points, 3, 2);
+	VectorView<const double> ys(points + 1, 3, 2);
+
+	EXPECT_EQ(3, xs.size());
+	EXPECT_DOUBLE_EQ(2.0, xs(1));
+	EXPECT_DOUBLE_EQ(30.0, ys(2));
+
+	const Vector<double, Dynamic> sum = xs + ys;
+	EXPECT_DOUBLE_EQ(22.0, sum(1));
+
+	xs = xs + 0.5 * ys;
+	EXPECT_DOUBLE_EQ(6.0, points[0]);
+	EXPECT_DOUBLE_EQ(10.0, points[1]);
+	EXPECT_DOUBLE_EQ(18.0, points[4]);
+
+	const Vector<double, Dynamic> values = { -1.0, -2.0, -3.0 };
+	xs = values;
+	EXPECT_DOUBLE_EQ(-3.0, points[4]);
+	EXPECT_DOUBLE_EQ(30.0, points[5]);
+}
+
+/*
+ * Teste une vue avec des pas sur une matrice (sous-bloc d'un tableau)
+ */
+TEST(TestMap, MatrixView_Stride_Ok)
+{
+	// Tableau 3x4 par colonnes; la vue couvre les lignes 1 et 2 des colonnes 1 à 3
+	double data[12];
+	for (auto k = 0; k < 12; ++k)
+	{
+		data[k] = static_cast<double>(k);
+	}
+	MatrixView<double> view(data + 1 + 3, 2, 3, 1, 3);
+
+	EXPECT_DOUBLE_EQ(4.0, view(0, 0));
+	EXPECT_DOUBLE_EQ(11.0, view(1, 2));
+
+	const Vector<double, Dynamic> x = { 1.0, 0.0, -1.0 };
+	const Vector<double, Dynamic> product = view * x;
+	ASSERT_EQ(2, product.size());
+	EXPECT_DOUBLE_EQ(4.0 - 10.0, product(0));
+	EXPECT_DOUBLE_EQ(5.0 - 11.0, product(1));
+
+	const Matrix<double, Dynamic, Dynamic> copy = 2.0 * view;
+	EXPECT_DOUBLE_EQ(22.0, copy(1, 2));
+
+	view = copy;
+	EXPECT_DOUBLE_EQ(22.0, data[11]);
+	EXPECT_DOUBLE_EQ(0.0, data[0]);
+	EXPECT_DOUBLE_EQ(3.0, data[3]);
+}
@@ -588,4 +588,49 @@ TEST(TestLabo1, Operator_Inverse_Matrix_Ok)
 
 	EXPECT_EQ(-4, resultRowMatrix(1, 1));
 	EXPECT_DOUBLE_EQ(-4.0, resultColMatrix(1, 1));
-}
\ No newline at end of file
+}
+
+/*
+ * Teste qu'une expression vectorielle composée est évaluée correctement, même
+ * lorsque la destination apparaît dans l'expression
+ */
+TEST(TestLabo1, Operator_Expression_Vector_Ok)
+{
+	Vector<double, Dynamic> x{ 1.0, 2.0, 3.0 };
+	const Vector<double, Dynamic> v{ 4.0, -5.0, 6.0 };
+
+	x = x + 0.5 * v - (-x) * 2.0;
+
+	EXPECT_EQ(3, x.size());
+	EXPECT_DOUBLE_EQ(5.0, x(0));
+	EXPECT_DOUBLE_EQ(3.5, x(1));
+	EXPECT_DOUBLE_EQ(12.0, x(2));
+
+	const auto difference = x - v;
+	EXPECT_DOUBLE_EQ(1.0 + 8.5 * 8.5 + 6.0 * 6.0, difference.squaredNorm());
+}
+
+/*
+ * Teste qu'une expression matricielle composée est évaluée correctement dans
+ * une matrice de l'un ou l'autre des types de stockage
+ */
+TEST(TestLabo1, Operator_Expression_Matrix_Ok)
+{
+	const Matrix<double, Dynamic, Dynamic, RowStorage> left{ {1.0, 2.0}, {3.0, 4.0} };
+	const Matrix<double, Dynamic, Dynamic, ColumnStorage> right{ {5.0, 6.0}, {7.0, 8.0} };
+
+	const Matrix<double, Dynamic, Dynamic, ColumnStorage> colResult = 2.0 * left - right + (-right);
+	Matrix<double, Dynamic, Dynamic, RowStorage> rowResult;
+	rowResult = 2.0 * left - right + (-right);
+
+	EXPECT_EQ(2, colResult.rows());
+	EXPECT_EQ(2, rowResult.cols());
+	for (auto i = 0; i < 2; ++i)
+	{
+		for (auto j = 0; j < 2; ++j)
+		{
+			EXPECT_DOUBLE_EQ(2.0 * left(i, j) - 2.0 * right(i, j), colResult(i, j));
+			EXPECT_DOUBLE_EQ(colResult(i, j), rowResult(i, j));
+		}
+	}
+}
@@ -0,0 +1,170 @@
+/**
+ * @file Simd_Test.cpp
+ *
+ * @brief Unit tests for the SIMD kernels.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+
+#include "../DenseStorage.h"
+#include "../Operators.h"
+#include "../Simd.h"
+#include "../Vector.h"
+
+using namespace gti320;
+
+namespace
+{
+	// Tailles couvrant la boucle vectorisée et le traitement des derniers éléments
+	const int testSizes[] = { 0, 1, 3, 7, 8, 17, 33, 100 };
+
+	Vector<double, Dynamic> makeVector(int size, double offset)
+	{
+		Vector<double, Dynamic> vector(size);
+		for (auto i = 0; i < size; ++i)
+		{
+			vector(i) = offset + 0.5 * i - 0.01 * i * i;
+		}
+		return vector;
+	}
+}
+
+/*
+ * Teste que les tampons des stockages dynamiques sont alignés sur 64 octets
+ */
+TEST(TestSimd, DenseStorage_Dynamic_Alignment_Ok)
+{
+	DenseStorage<double, Dynamic> storage(13);
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(storage.data()) % StorageAlignment);
+
+	storage.resize(1000);
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(storage.data()) % StorageAlignment);
+
+	DenseStorage<double, Dynamic> copy(storage);
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(copy.data()) % StorageAlignment);
+}
+
+/*
+ * Teste le produit scalaire et la norme vectorisés
+ */
+TEST(TestSimd, DotAndSquaredNorm_Ok)
+{
+	for (int size : testSizes)
+	{
+		const auto left = makeVector(size, 1.0);
+		const auto right = makeVector(size, -2.0);
+
+		double expectedDot = 0.0;
+		double expectedSquaredNorm = 0.0;
+		for (auto i = 0; i < size; ++i)
+		{
+			expectedDot += left(i) * right(i);
+			expectedSquaredNorm += left(i) * left(i);
+		}
+
+		EXPECT_NEAR(expectedDot, left.dot(right), 1e-12 * (1.0 + std::abs(expectedDot)));
+		EXPECT_NEAR(expectedSquaredNorm, left.squaredNorm(), 1e-12 * (1.0 + expectedSquaredNorm));
+	}
+}
+
+/*
+ * Teste axpy, la mise à l'échelle, l'addition et la soustraction vectorisées
+ */
+TEST(TestSimd, ElementWiseKernels_Ok)
+{
+	for (int size : testSizes)
+	{
+		const auto x = makeVector(size, 3.0);
+		const auto original = makeVector(size, -1.0);
+
+		auto y = original;
+		y = y + 0.25 * x;
+		for (auto i = 0; i < size; ++i)
+		{
+			EXPECT_NEAR(original(i) + 0.25 * x(i), y(i), 1e-12);
+		}
+
+		y = original;
+		y = y - 0.25 * x;
+		for (auto i = 0; i < size; ++i)
+		{
+			EXPECT_NEAR(original(i) - 0.25 * x(i), y(i), 1e-12);
+		}
+
+		y = original;
+		y = -3.0 * y;
+		for (auto i = 0; i < size; ++i)
+		{
+			EXPECT_DOUBLE_EQ(-3.0 * original(i), y(i));
+		}
+
+		const Vector<double, Dynamic> sum = x + original;
+		const Vector<double, Dynamic> difference = x - original;
+		for (auto i = 0; i < size; ++i)
+		{
+			EXPECT_DOUBLE_EQ(x(i) + original(i), sum(i));
+			EXPECT_DOUBLE_EQ(x(i) - original(i), difference(i));
+		}
+	}
+}
+
+/*
+ * Teste que la destination peut apparaître comme opérande de droite
+ */
+TEST(TestSimd, ElementWiseKernels_Aliasing_Ok)
+{
+	const auto x = makeVector(9, 2.0);
+	auto y = makeVector(9, 1.0);
+	const auto original = y;
+
+	y = x - y;
+	for (auto i = 0; i < 9; ++i)
+	{
+		EXPECT_DOUBLE_EQ(x(i) - original(i), y(i));
+	}
+
+	y = original;
+	y = y + 2.0 * y;
+	for (auto i = 0; i < 9; ++i)
+	{
+		EXPECT_DOUBLE_EQ(3.0 * original(i), y(i));
+	}
+}
+
+/*
+ * Teste la division et la racine carrée des paquets : elles doivent donner
+ * exactement le résultat scalaire
+ */
+TEST(TestSimd, Packet_DivideSquareRoot_Ok)
+{
+	typedef simd::PacketOf<double>::Type Packet;
+
+	double numerators[Packet::Width];
+	double denominators[Packet::Width];
+	for (auto i = 0; i < Packet::Width; ++i)
+	{
+		numerators[i] = 1.0 + 3.0 * i;
+		denominators[i] = 7.0 - 0.5 * i;
+	}
+
+	double quotients[Packet::Width];
+	double roots[Packet::Width];
+	Packet::store(quotients, Packet::divide(Packet::load(numerators), Packet::load(denominators)));
+	Packet::store(roots, Packet::squareRoot(Packet::load(numerators)));
+
+	for (auto i = 0; i < Packet::Width; ++i)
+	{
+		EXPECT_EQ(numerators[i] / denominators[i], quotients[i]);
+		EXPECT_EQ(std::sqrt(numerators[i]), roots[i]);
+	}
+
+	EXPECT_EQ(2.5, simd::ScalarPacket<double>::divide(5.0, 2.0));
+	EXPECT_EQ(3.0, simd::ScalarPacket<double>::squareRoot(9.0));
+}
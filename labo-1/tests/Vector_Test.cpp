@@ -184,4 +184,45 @@ TEST(TestLabo1, Vector_norm_Ok)
 	EXPECT_DOUBLE_EQ(5, vector2.norm());
 	EXPECT_DOUBLE_EQ(sqrt(14), vector3.norm());
 	EXPECT_DOUBLE_EQ(sqrt(130), vector4.norm());
-}
\ No newline at end of file
+}
+
+/*
+ * Teste que le déplacement d'un vecteur dynamique transfère son tampon
+ */
+TEST(TestLabo1, Vector_Move_Ok)
+{
+	Vector<double, Dynamic> source{ 1.0, 2.0, 3.0 };
+	const double* data = source.data();
+
+	Vector<double, Dynamic> vector(std::move(source));
+	EXPECT_EQ(data, vector.data());
+	EXPECT_EQ(3, vector.size());
+	EXPECT_EQ(0, source.size());
+
+	Vector<double, Dynamic> other{ 4.0 };
+	other = std::move(vector);
+	EXPECT_EQ(data, other.data());
+	EXPECT_DOUBLE_EQ(3.0, other(2));
+
+	Vector<double, Dynamic> swapped{ 5.0, 6.0 };
+	other.swap(swapped);
+	EXPECT_EQ(data, swapped.data());
+	EXPECT_EQ(2, other.size());
+	EXPECT_DOUBLE_EQ(6.0, other(1));
+}
+
+/*
+ * Teste que conservativeResize conserve les éléments du vecteur
+ */
+TEST(TestLabo1, Vector_conservativeResize_Ok)
+{
+	Vector<double, Dynamic> vector{ 1.0, 2.0 };
+
+	vector.conservativeResize(3);
+
+	EXPECT_EQ(3, vector.rows());
+	EXPECT_EQ(3, vector.size());
+	EXPECT_DOUBLE_EQ(1.0, vector(0));
+	EXPECT_DOUBLE_EQ(2.0, vector(1));
+	EXPECT_DOUBLE_EQ(0.0, vector(2));
+}
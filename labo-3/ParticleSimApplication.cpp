@@ -32,220 +32,20 @@ using namespace gti320;
 
 namespace
 {
-	static const double DELTA_T = 0.01; // secondes
-
-	/**
-	 * Crée un système masse-ressort qui simule un tissu suspendu
-	 */
-	static inline void createHangingCloth(ParticleSystem& particleSystem, double k)
-	{
-		particleSystem.clear();
-
-		const int N = 16;
-		const int x_start = 240;
-		const int y_start = 100;
-		const int dx = 32;
-		const int dy = 32;
-
-		int index = 0;
-		for (int i = 0; i < N; ++i)
-		{
-			for (int j = 0; j < N; ++j)
-			{
-				const int x = x_start + j * dx;
-				const int y = y_start + i * dy;
-
-				Particle particle(Vector2d(x, y), Vector2d(0, 0), Vector2d(0, 0), 1.0);
-				if (j == 0 && i == (N - 1)) particle.fixed = true;
-				if (j == (N - 1) && i == (N - 1)) particle.fixed = true;
-				particleSystem.addParticle(particle);
-
-				if (i > 0)
-				{
-					Spring s(index - N, index, k, (double)dy);
-					particleSystem.addSpring(s);
-				}
-				if (j > 0)
-				{
-					Spring s(index - 1, index, k, (double)dx);
-					particleSystem.addSpring(s);
-				}
-
-				if (i > 0 && j > 0)
-				{
-					Spring s(index - N - 1, index, k, std::sqrt((double)dx * dx + (double)dy * dy));
-					particleSystem.addSpring(s);
-				}
-				++index;
-			}
-		}
-	}
-
-	/**
-	 * Crée un système masse-ressort qui simule une corde suspendu par ses
-	 * extrémités.
-	 */
-	static inline void createHangingRope(ParticleSystem& particleSystem, double k)
-	{
-		particleSystem.clear();
-
-		const int N = 20;
-		const int x_start = 200;
-		const int dx = 32;
-
-		int index = 0;
-		for (int j = 0; j < N; ++j)
-		{
-			const int x = x_start + j * dx;
-			const int y = 480;
-
-			Particle particle(Vector2d(x, y), Vector2d(0, 0), Vector2d(0, 0), 1.0);
-			particle.fixed = (index == 0) || (index == N - 1);
-			particleSystem.addParticle(particle);
-			if (j > 0)
-			{
-				Spring s(index - 1, index, k, (double)dx);
-				particleSystem.addSpring(s);
-			}
-			++index;
-		}
-	}
-
-	/**
-	 * Crée un système masse-ressort qui simule une poutre flexible
-	 */
-	static inline void createBeam(ParticleSystem& particleSystem, double k)
-	{
-		particleSystem.clear();
-
-		const int N = 20;
-		const int x_start = 200;
-		const int y_start = 400;
-		const int dx = 32;
-		const int dy = 32;
-
-		int index = 0;
-		for (int j = 0; j < N; ++j)
-		{
-			const int x = x_start + j * dx;
-
-			// Bottom particle
-			{
-				Particle particle(Vector2d(x, y_start), Vector2d(0, 0), Vector2d(0, 0), 1.0);
-				particle.fixed = (j == 0);
-				particleSystem.addParticle(particle);
-				if (j > 0)
-				{
-					Spring s(index - 1, index, k, (double)sqrt((double)dx * dx + (double)dy * dy));
-					particleSystem.addSpring(s);
-					Spring s2(index - 2, index, k, (double)dx);
-					particleSystem.addSpring(s2);
-				}
-				++index;
-			}
-
-
-			// Top particle
-			{
-				Particle particle(Vector2d(x, y_start + dy), Vector2d(0, 0), Vector2d(0, 0), 1.0);
-				particle.fixed = (j == 0);
-				particleSystem.addParticle(particle);
-				Spring s(index - 1, index, k, (double)dy);
-				particleSystem.addSpring(s);
-				if (j > 0)
-				{
-					Spring s2(index - 2, index, k, (double)dx);
-					particleSystem.addSpring(s2);
-					Spring s3(index - 3, index, k, (double)sqrt((double)dx * dx + (double)dy * dy));
-					particleSystem.addSpring(s3);
-				}
-				++index;
-			}
-		}
-	}
-
-
-	/**
-	 * Crée un système masse-ressort qui simule un pendule flexible
-	 */
-	static inline void createVotreExemple(ParticleSystem& particleSystem, double k)
-	{
-		particleSystem.clear();
-
-		// TODO Amusez-vous. Rendu ici, vous le méritez.
-
-
-
-		Particle pillar1(Vector2d(400, 500), Vector2d(0, 0), Vector2d(0, 0), 1.0);
-		pillar1.fixed = true;
-		particleSystem.addParticle(pillar1);
-
-		Particle pillar2(Vector2d(600, 500), Vector2d(0, 0), Vector2d(0, 0), 1.0);
-		pillar2.fixed = true;
-		particleSystem.addParticle(pillar2);
-
-		Particle pillarBase(Vector2d(500, 450), Vector2d(0, 0), Vector2d(0, 0), 1.0);
-		pillar2.fixed = true;
-		particleSystem.addParticle(pillarBase);
-
-		Spring spring1(1, 2, k, std::sqrt(100 * 100 + 50 * 50));
-		particleSystem.addSpring(spring1);
-
-		Spring spring2(0, 2, k, std::sqrt(100 * 100 + 50 * 50));
-		particleSystem.addSpring(spring2);
-
-		Particle cube1(Vector2d(500, 200), Vector2d(50, 0), Vector2d(0, 0), 100.0);
-		particleSystem.addParticle(cube1);
-
-		Particle cube2(Vector2d(500, 150), Vector2d(50, 0), Vector2d(0, 0), 100.0);
-		particleSystem.addParticle(cube2);
-
-		Particle cube3(Vector2d(525, 175), Vector2d(50, 0), Vector2d(0, 0), 100.0);
-		particleSystem.addParticle(cube3);
-
-		Particle cube4(Vector2d(475, 175), Vector2d(50, 0), Vector2d(0, 0), 100.0);
-		particleSystem.addParticle(cube4);
-
-		Particle cube5(Vector2d(500, 175), Vector2d(50, 0), Vector2d(0, 0), 100.0);
-		particleSystem.addParticle(cube5);
-
-		Spring spring3(2, 3, k, 150);
-		particleSystem.addSpring(spring3);
-
-		Spring spring5(3, 5, k, std::sqrt(25 * 25 + 25 * 25));
-		particleSystem.addSpring(spring5);
-
-		Spring spring6(3, 6, k, std::sqrt(25 * 25 + 25 * 25));
-		particleSystem.addSpring(spring6);
-
-		Spring spring7(4, 5, k, std::sqrt(25 * 25 + 25 * 25));
-		particleSystem.addSpring(spring7);
-
-		Spring spring8(4, 6, k, std::sqrt(25 * 25 + 25 * 25));
-		particleSystem.addSpring(spring8);
-
-		Spring spring9(3, 7, k, 25);
-		particleSystem.addSpring(spring9);
-
-		Spring spring10(4, 7, k, 25);
-		particleSystem.addSpring(spring10);
-
-		Spring spring11(5, 7, k, 25);
-		particleSystem.addSpring(spring11);
-
-		Spring spring12(6, 7, k, 25);
-		particleSystem.addSpring(spring12);
-	}
+	static const double DELTA_T = 0.01; // secondes, divisé en m_substeps pas (voir SimulationThread)
 }
 
 ParticleSimApplication::ParticleSimApplication()
 : nanogui::Screen(Eigen::Vector2i(1280, 820), "GTI320 Labo 03", true, false, 8, 8, 24, 8, 0, 4, 1),
-  m_particleSystem(), m_stepping(false), m_stiffness(300), m_kmax(10), m_solverType(kGaussSeidel), m_fpsCounter(0), m_fpsTime(0.0)
+  m_simulation(DELTA_T), m_stepping(false), m_stiffness(300), m_kmax(10), m_substeps(1), m_maxSubsteps(5), m_fpsCounter(0), m_fpsTime(0.0)
 {
 	initGui();
 
-	createBeam(m_particleSystem, m_stiffness); // le modèle "poutre" est sélectionné à l'initialisation
-	m_particleSystem.pack(m_p0, m_v0, m_f0);
+	m_simulation.setSubsteps(m_substeps);
+	m_simulation.setMaxSubsteps(m_maxSubsteps);
+
+	m_simulation.loadScene(kBeam); // le modèle "poutre" est sélectionné à l'initialisation
+	m_simulation.start();
 
 	performLayout();
 	reset();
@@ -275,6 +75,8 @@ void ParticleSimApplication::initGui()
 	// Intervalles des curseur
 	const auto stiffnessMinMax = std::make_pair<float, float>(0.0f, logf(5000.f));
 	const auto iterMinMax = std::make_pair<float, float>(1.f, 100.f);
+	const auto substepsMinMax = std::make_pair<float, float>(1.f, 10.f);
+	const auto maxSubstepsMinMax = std::make_pair<float, float>(1.f, 20.f);
 
 	// Affichage du FPS
 	m_panelFPS = new Widget(tools);
@@ -292,6 +94,14 @@ void ParticleSimApplication::initGui()
 	m_textboxFrames->setFixedWidth(60);
 	m_textboxFrames->setValue("0");
 
+	// Affichage des statistiques du solveur (itérations / résidu relatif)
+	m_panelSolverStats = new Widget(tools);
+	m_panelSolverStats->setLayout(new BoxLayout(Orientation::Horizontal, Alignment::Middle, 0, 5));
+	m_labelSolverStats = new Label(m_panelSolverStats, "Iterations :");
+	m_textboxSolverStats = new TextBox(m_panelSolverStats);
+	m_textboxSolverStats->setFixedWidth(120);
+	m_textboxSolverStats->setValue("-");
+
 	// Boutons pour le choix du solveur
 	m_panelSolver = new Widget(tools);
 	m_panelSolver->setLayout(new BoxLayout(Orientation::Vertical, Alignment::Middle, 0, 5));
@@ -299,17 +109,53 @@ void ParticleSimApplication::initGui()
 	Button* b = new Button(m_panelSolver, "Gauss-Seidel");
 	b->setFlags(Button::RadioButton);
 	b->setPushed(true);
-	b->setCallback([this] { m_solverType = kGaussSeidel; });
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setSolverType(kGaussSeidel); }); });
+	b = new Button(m_panelSolver, "Gauss-Seidel (multicolor)");
+	b->setFlags(Button::RadioButton);
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setSolverType(kColoredGaussSeidel); }); });
 	b = new Button(m_panelSolver, "Jacobi");
 	b->setFlags(Button::RadioButton);
-	b->setCallback([this] { m_solverType = kJacobi; });
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setSolverType(kJacobi); }); });
 	b = new Button(m_panelSolver, "Cholesky");
-	b->setCallback([this] { m_solverType = kCholesky; });
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setSolverType(kCholesky); }); });
+	b->setFlags(Button::RadioButton);
+	b = new Button(m_panelSolver, "Conjugate Gradient");
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setSolverType(kConjugateGradient); }); });
+	b->setFlags(Button::RadioButton);
+	b = new Button(m_panelSolver, "PCG");
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setSolverType(kPCG); }); });
 	b->setFlags(Button::RadioButton);
 	b = new Button(m_panelSolver, "None");
-	b->setCallback([this] { m_solverType = kNone; });
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setSolverType(kNone); }); });
 	b->setFlags(Button::RadioButton);
 
+	// Boutons pour le choix du préconditionneur (PCG)
+	Widget* panelPreconditioner = new Widget(tools);
+	panelPreconditioner->setLayout(new BoxLayout(Orientation::Vertical, Alignment::Middle, 0, 5));
+	new Label(panelPreconditioner, "Preconditioner (PCG) : ");
+	b = new Button(panelPreconditioner, "Block Jacobi");
+	b->setFlags(Button::RadioButton);
+	b->setPushed(true);
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setPreconditionerType(kBlockJacobiPreconditioner); }); });
+	b = new Button(panelPreconditioner, "Jacobi");
+	b->setFlags(Button::RadioButton);
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setPreconditionerType(kJacobiPreconditioner); }); });
+
+	// Boutons pour le choix de l'estimé initial (Jacobi et Gauss-Seidel)
+	Widget* panelWarmStart = new Widget(tools);
+	panelWarmStart->setLayout(new BoxLayout(Orientation::Vertical, Alignment::Middle, 0, 5));
+	new Label(panelWarmStart, "Initial guess (Jacobi / GS) : ");
+	b = new Button(panelWarmStart, "Extrapolated velocity");
+	b->setFlags(Button::RadioButton);
+	b->setPushed(true);
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setWarmStartType(kWarmStartExtrapolated); }); });
+	b = new Button(panelWarmStart, "Previous velocity");
+	b->setFlags(Button::RadioButton);
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setWarmStartType(kWarmStartPrevious); }); });
+	b = new Button(panelWarmStart, "b");
+	b->setFlags(Button::RadioButton);
+	b->setCallback([this] { m_simulation.post([](Simulator& simulator) { simulator.setWarmStartType(kNoWarmStart); }); });
+
 	// Curseur de rigidité 
 	Widget* panelSimControl = new Widget(tools);
 	panelSimControl->setLayout(new BoxLayout(Orientation::Vertical, Alignment::Middle, 0, 5));
@@ -322,6 +168,8 @@ void ParticleSimApplication::initGui()
 	m_sliderStiffness->setCallback([this](float value)
 	{
 		m_stiffness = exp(value);
+		const double stiffness = m_stiffness;
+		m_simulation.post([stiffness](Simulator& simulator) { simulator.setStiffness(stiffness); });
 		onStiffnessSliderChanged();
 	});
 	m_sliderStiffness->setValue(logf(300.f));
@@ -338,15 +186,50 @@ void ParticleSimApplication::initGui()
 	sliderMaxIter->setCallback([this, textboxMaxIter](float value)
 	{
 		m_kmax = (int)value;
+		const int kmax = m_kmax;
+		m_simulation.post([kmax](Simulator& simulator) { simulator.setMaxIterations(kmax); });
 		textboxMaxIter->setValue(std::to_string(m_kmax));
 	});
 
+	// Curseur du nombre de pas par intervalle DELTA_T
+	Widget* panelSubsteps = new Widget(panelSimControl);
+	panelSubsteps->setLayout(new BoxLayout(Orientation::Horizontal, Alignment::Middle, 0, 5));
+	new Label(panelSubsteps, "Substeps : ");
+	Slider* sliderSubsteps = new Slider(panelSubsteps);
+	sliderSubsteps->setRange(substepsMinMax);
+	TextBox* textboxSubsteps = new TextBox(panelSubsteps);
+	textboxSubsteps->setValue(std::to_string(m_substeps));
+	sliderSubsteps->setValue(m_substeps);
+	sliderSubsteps->setCallback([this, textboxSubsteps](float value)
+	{
+		m_substeps = (int)value;
+		m_simulation.setSubsteps(m_substeps);
+		textboxSubsteps->setValue(std::to_string(m_substeps));
+	});
+
+	// Curseur du nombre maximal de pas enchaînés pour rattraper le temps réel
+	Widget* panelMaxSubsteps = new Widget(panelSimControl);
+	panelMaxSubsteps->setLayout(new BoxLayout(Orientation::Horizontal, Alignment::Middle, 0, 5));
+	new Label(panelMaxSubsteps, "Max substeps : ");
+	Slider* sliderMaxSubsteps = new Slider(panelMaxSubsteps);
+	sliderMaxSubsteps->setRange(maxSubstepsMinMax);
+	TextBox* textboxMaxSubsteps = new TextBox(panelMaxSubsteps);
+	textboxMaxSubsteps->setValue(std::to_string(m_maxSubsteps));
+	sliderMaxSubsteps->setValue(m_maxSubsteps);
+	sliderMaxSubsteps->setCallback([this, textboxMaxSubsteps](float value)
+	{
+		m_maxSubsteps = (int)value;
+		m_simulation.setMaxSubsteps(m_maxSubsteps);
+		textboxMaxSubsteps->setValue(std::to_string(m_maxSubsteps));
+	});
+
 	// Bouton «Simulate»
 	Button* startStopButton = new Button(panelSimControl, "Simulate");
 	startStopButton->setFlags(Button::ToggleButton);
 	startStopButton->setChangeCallback([this](bool val)
 	{
 		m_stepping = val;
+		m_simulation.setStepping(val);
 		if (val)
 		{
 			m_prevTime = glfwGetTime();
@@ -359,7 +242,7 @@ void ParticleSimApplication::initGui()
 	stepButton->setCallback([this]
 	{
 		if (!m_stepping)
-			step(DELTA_T);
+			m_simulation.requestStep();
 	});
 
 	// Bouton «Reset»
@@ -376,34 +259,53 @@ void ParticleSimApplication::initGui()
 	Button* loadClothButton = new Button(panelExamples, "Cloth");
 	loadClothButton->setCallback([this]
 	{
-		createHangingCloth(m_particleSystem, m_stiffness);
-		m_particleSystem.pack(m_p0, m_v0, m_f0);
+		m_simulation.loadScene(kHangingCloth);
 		reset();
 	});
 
 	Button* loadBeamButton = new Button(panelExamples, "Beam");
 	loadBeamButton->setCallback([this]
 	{
-		createBeam(m_particleSystem, m_stiffness);
-		m_particleSystem.pack(m_p0, m_v0, m_f0);
+		m_simulation.loadScene(kBeam);
 		reset();
 	});
 
 	Button* loadRopeButton = new Button(panelExamples, "Rope");
 	loadRopeButton->setCallback([this]
 	{
-		createHangingRope(m_particleSystem, m_stiffness);
-		m_particleSystem.pack(m_p0, m_v0, m_f0);
+		m_simulation.loadScene(kHangingRope);
 		reset();
 	});
 
 	Button* loadVotreExemple = new Button(panelExamples, "Le vôtre");
 	loadVotreExemple->setCallback([this]
 	{
-		createVotreExemple(m_particleSystem, m_stiffness);
-		m_particleSystem.pack(m_p0, m_v0, m_f0);
+		m_simulation.loadScene(kVotreExemple);
 		reset();
 	});
+
+	// Fenêtre des durées des étapes d'un pas : minimum, moyenne et 99e
+	// centile sur les derniers pas
+	Window* profiling = new Window(this, "Step timings (ms)");
+	profiling->setPosition(Vector2i(8, 680));
+	profiling->setLayout(new GridLayout(Orientation::Horizontal, kNumberOfStepPhases + 2, Alignment::Middle, 10, 6));
+	new Label(profiling, "");
+	for (int phase = 0; phase < kNumberOfStepPhases; ++phase)
+	{
+		new Label(profiling, StepProfiler::getPhaseName(static_cast<eStepPhase>(phase)), "sans-bold");
+	}
+	new Label(profiling, "step", "sans-bold");
+
+	const char* const statisticNames[3] = { "min", "mean", "p99" };
+	for (int statistic = 0; statistic < 3; ++statistic)
+	{
+		new Label(profiling, statisticNames[statistic], "sans-bold");
+		for (int column = 0; column <= kNumberOfStepPhases; ++column)
+		{
+			m_labelsProfile[statistic][column] = new Label(profiling, "-");
+			m_labelsProfile[statistic][column]->setFixedWidth(100);
+		}
+	}
 }
 
 
@@ -426,19 +328,23 @@ bool ParticleSimApplication::keyboardEvent(int key, int scancode, int action, in
  * Boucle principale
  *
  * Cette fonction est appelée périodiquement lorsque le programme est actif.
- * C'est ici que tout se passe. Si la simulation est en cours, la fonction
- * `step` est appelée pour faire avancer le système d'un intervalle de temps
- * DELTA_T. Ensuite, l'affichage est mis à jour.
+ * La simulation avance dans son propre fil d'exécution, avec un pas fixe qui
+ * suit le temps réel (voir SimulationThread) : l'affichage récupère le
+ * dernier état publié, sans attendre la fin d'un pas, puis le canvas
+ * l'affiche en interpolant entre les deux derniers pas.
  */
 void ParticleSimApplication::drawContents()
 {
+	if (m_simulation.updateSnapshot())
+	{
+		updateSimulationStats();
+	}
+
 	if (m_stepping)
 	{
 		auto now = glfwGetTime();
 		double dt = now - m_prevTime;
 
-		step(DELTA_T);
-
 		// Update frames per second 
 		//
 		m_fpsTime += dt;
@@ -453,105 +359,56 @@ void ParticleSimApplication::drawContents()
 			m_textboxFPS->setValue(buf);
 		}
 		m_prevTime = now;
-
-		updateFrameCounter();
 	}
 }
 
 /**
- * Appelée lorsque le curseur de rigidité est modifié. La nouvelle rigidité est
- * affectée à tous les ressorts
+ * Appelée lorsque le curseur de rigidité est modifié (la nouvelle rigidité est
+ * affectée à tous les ressorts par le simulateur) : affiche la rigidité
  */
 void ParticleSimApplication::onStiffnessSliderChanged()
 {
-	// Update all springs with the slider value
-	for (Spring& s : getParticleSystem().getSprings())
-	{
-		s.k = m_stiffness;
-	}
-
 	char buf[16];
 	snprintf(buf, sizeof(buf), "%4.0f", m_stiffness);
 	m_textboxStiffness->setValue(buf);
 }
 
-/**
- * Effectue un pas de simulation de taille dt.
- */
-void ParticleSimApplication::step(double dt)
-{
-	// Construction des matrices de masse et de rigidité
-	//
-	m_particleSystem.buildMassMatrix(m_M);
-	m_particleSystem.buildDfDx(m_dfdx);
-
-	// Calcul des forces actuelles sur chacune de sparticules
-	//
-	m_particleSystem.computeForces();
-	m_canvas->applyMouseSpring();
-
-	// Assemblage des vecteurs d'états.
-	// 
-	m_particleSystem.pack(m_x, m_v, m_f);
-
-	const Matrix<double, Dynamic, Dynamic> A = m_M - (dt * dt) * m_dfdx;
-	const Vector<double, Dynamic> b = dt * m_f + m_M * m_v;
-
-	// Solve the linear system A*v_plus = b using the selected solver.
-	// 
-	// Résolution du système d'équations  `A*v_plus = b`.
-	Vector<double, Dynamic> v_plus;
-	Vector<double, Dynamic> acc; // vecteur d'accélérations
-	switch (m_solverType)
-	{
-	case kGaussSeidel:
-		gaussSeidel(A, b, v_plus, m_kmax);
-		break;
-	case kCholesky:
-		cholesky(A, b, v_plus);
-		break;
-	default:
-		jacobi(A, b, v_plus, m_kmax);
-		break;
-	case kNone:
-		// N'utilise pas de solveur, il s'agit de l'implémentation naive de
-		// l'intégration d'Euler.
-		acc.resize(m_M.rows()); // vecteur d'accélérations
-		for (int i = 0; i < m_M.rows(); ++i)
-			acc(i) = (1.0 / m_M(i, i)) * m_f(i);
-		v_plus = m_v + dt * acc;
-		break;
-	}
-
-	// Mise à jour du vecteur d'état de position via l'intégration d'Euler
-	// implicite. Les nouvelles position sont calculées à partir des position
-	// actuelles m_x et des nouvelles vitesses v_plus. Les nouvelles positions
-	// sont stockées directement dans le vecteur m_x.
-	m_x = m_x + dt * v_plus;
-
-	// Affecte les valeurs calculées dans le vecteurs d'états aux particules du
-	// système
-	m_particleSystem.unpack(m_x, v_plus);
-}
-
 /**
  * Réinitialisation du système de particules
  */
 void ParticleSimApplication::reset()
 {
-	m_frameCounter = 0;
-	m_particleSystem.unpack(m_p0, m_v0);
+	m_simulation.reset();
 
 	onStiffnessSliderChanged();
 }
 
 /**
- * Mise à jour du compteur de frames
+ * Mise à jour du compteur de frames, des statistiques du solveur et des
+ * durées des étapes à partir du dernier état publié
  */
-void ParticleSimApplication::updateFrameCounter()
+void ParticleSimApplication::updateSimulationStats()
 {
-	++m_frameCounter;
-	char buf[16];
-	snprintf(buf, sizeof(buf), "%d", m_frameCounter);
+	const SimulationSnapshot& snapshot = m_simulation.getSnapshot();
+
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%d", snapshot.stepCount);
 	m_textboxFrames->setValue(buf);
+
+	// Cholesky : "f" lorsque le pas a refait la factorisation
+	const SolverStats& solverStats = snapshot.solverStats;
+	snprintf(buf, sizeof(buf), "%d%s / %.1e", solverStats.iterations, solverStats.refactored ? "f" : "", solverStats.residual);
+	m_textboxSolverStats->setValue(solverStats.time > 0.0 ? buf : "-");
+
+	// Durées des étapes, en millisecondes
+	for (int column = 0; column <= kNumberOfStepPhases; ++column)
+	{
+		const TimingSummary& summary = column < kNumberOfStepPhases ? snapshot.profile.phases[column] : snapshot.profile.step;
+		const double values[3] = { summary.min, summary.mean, summary.p99 };
+		for (int statistic = 0; statistic < 3; ++statistic)
+		{
+			snprintf(buf, sizeof(buf), "%.3f", 1000.0 * values[statistic]);
+			m_labelsProfile[statistic][column]->setCaption(summary.count > 0 ? buf : "-");
+		}
+	}
 }
@@ -14,8 +14,7 @@
 
 #include <nanogui/screen.h>
 
-#include "ParticleSystem.h"
-#include "Solvers.hpp"
+#include "SimulationThread.h"
 
 class ParticleSimGLCanvas;
 
@@ -33,19 +32,17 @@ public:
 
   nanogui::Window* getWindow() const { return m_window; }
 
-  const gti320::ParticleSystem& getParticleSystem() const { return m_particleSystem; }
+  /**
+   * Dernier état du système récupéré du fil de simulation
+   */
+  const gti320::SimulationSnapshot& getSnapshot() const { return m_simulation.getSnapshot(); }
 
-  gti320::ParticleSystem& getParticleSystem() { return m_particleSystem; }
+  gti320::SimulationThread& getSimulation() { return m_simulation; }
 
 private:
 
   void initGui();
 
-  /**
-   * Effectue un pas de simulation d'un intervale de temps dt.
-   */
-  void step(double dt);
-
   /**
    * Fonction appelée lorsque le glisseur de rigidité est modifié
    */
@@ -56,7 +53,11 @@ private:
    */
   void reset();
 
-  void updateFrameCounter();
+  /**
+   * Affiche le nombre de pas, les statistiques du solveur et les durées des
+   * étapes du dernier état
+   */
+  void updateSimulationStats();
 
   ParticleSimGLCanvas* m_canvas;
   nanogui::Window* m_window;
@@ -66,11 +67,13 @@ private:
   Widget* m_panelFrames;
   Widget* m_panelStiffness;
   Widget* m_panelSolver;
+  Widget* m_panelSolverStats;
   Widget* m_panelRayleigh;
 
   // Textboxes 
   nanogui::TextBox *m_textboxFPS;
   nanogui::TextBox *m_textboxFrames;
+  nanogui::TextBox* m_textboxSolverStats;
   nanogui::TextBox *m_textboxStiffness;
   nanogui::TextBox* m_textboxRayleighAlpha;
   nanogui::TextBox* m_textboxRayleighBeta;
@@ -78,45 +81,33 @@ private:
   // Labels
   nanogui::Label* m_labelFPS;
   nanogui::Label* m_labelFrames;
+  nanogui::Label* m_labelSolverStats;
   nanogui::Label* m_labelStiffness;
   nanogui::Label* m_labelRayleighAlpha;
   nanogui::Label* m_labelRayleighBeta;
+  nanogui::Label* m_labelsProfile[3][gti320::kNumberOfStepPhases + 1]; // min / moyenne / p99 de chaque étape et du pas
 
   // Sliders
   nanogui::Slider* m_sliderStiffness;
   nanogui::Slider* m_sliderRayleighAlpha;
   nanogui::Slider* m_sliderRayleighBeta;
 
-  // Le système de particules
-  gti320::ParticleSystem m_particleSystem;
+  // Le simulateur, qui s'exécute dans son propre fil d'exécution
+  gti320::SimulationThread m_simulation;
 
   // The variable m_stepping is true if the simulation is running, 
-  // and step() will be called automatically
+  // and the simulation thread steps automatically
   bool m_stepping;                   // true lorsque la simulation est cours, false lorsqu'elles à l'arrêt
   double m_stiffness;                // la rigidité des ressorts
   int m_kmax;                        // nombre max d'itération pour les solveurs itératifs
-  gti320::eSolverType m_solverType;  // indique le choix du solveur
+  int m_substeps;                    // nombre de pas par intervalle DELTA_T
+  int m_maxSubsteps;                 // nombre maximal de pas enchaînés pour rattraper le temps réel
 
   // Variables pour le calcul du fps et le compteur de frames
   int m_fpsCounter;
   double m_fpsTime;
-  int m_frameCounter;
   double m_prevTime;
 
-  // Matrices du système
-  gti320::Matrix<double, gti320::Dynamic, gti320::Dynamic> m_M;   // matrice de masses
-  gti320::Matrix<double, gti320::Dynamic, gti320::Dynamic> m_dfdx;   // matrice de rigidité
-
-  // Vecteurs d'état
-  gti320::Vector<double, gti320::Dynamic> m_x;  // positions des particules
-  gti320::Vector<double, gti320::Dynamic> m_v;  // vélocités des particules
-  gti320::Vector<double, gti320::Dynamic> m_f;  // forces des particules
-
-  // État initial (utilisé pour réinitialiser le système)
-  gti320::Vector<double, gti320::Dynamic> m_p0; // positions des particules
-  gti320::Vector<double, gti320::Dynamic> m_v0; // vélocités des particules
-  gti320::Vector<double, gti320::Dynamic> m_f0; // forces des particules
-
   // Paramètre pour l'amortissement de Rayleigh 
   double m_alpha, m_beta;
 
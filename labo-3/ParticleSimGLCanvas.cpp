@@ -9,7 +9,7 @@
  */
 
 #include "ParticleSimGLCanvas.h"
-#include "ParticleSystem.h"
+#include "SimulationThread.h"
 
 using namespace nanogui;
 
@@ -17,47 +17,49 @@ namespace
 {
   static const double r = 6.0;
 
-  static inline gti320::Particle* pickParticle(std::vector<gti320::Particle>& particles, const gti320::Vector2d& mousePos)
+  // Shader minimaliste partagé par les particules et les ressorts
+  static const char* const vertexShader =
+       "#version 410\n"
+       "uniform mat4 modelViewProj;\n"
+       "uniform vec4 color;\n"
+       "in vec2 position;\n"
+       "void main() {\n"
+       "    gl_Position = modelViewProj * vec4(position.xy, -1, 1);\n"
+       "}";
+
+  static const char* const fragmentShader =
+       "#version 410\n"
+       "uniform vec4 color;\n"
+       "out vec4 frag_color;\n"
+       "void main() {\n"
+       "    frag_color = color;\n"
+       "}";
+
+  static inline int pickParticle(const gti320::SimulationSnapshot& snapshot, const gti320::Vector2d& mousePos)
     {
-      for (gti320::Particle& particle : particles)
+      const int numParticles = snapshot.getParticleCount();
+      for (int i = 0; i < numParticles; ++i)
         {
-          const double dist = (particle.x - mousePos).norm();
+          const gti320::Vector2d x(snapshot.positions(2 * i), snapshot.positions(2 * i + 1));
+          const double dist = (x - mousePos).norm();
           if (dist <= r)
             {
-              return &particle;
+              return i;
             }
         }
 
-      return nullptr;
+      return -1;
     }
 }
 
 ParticleSimGLCanvas::ParticleSimGLCanvas(ParticleSimApplication* _app) 
-     : nanogui::GLCanvas(_app->getWindow()), m_app(_app), m_selectedParticle(nullptr) 
+     : nanogui::GLCanvas(_app->getWindow()), m_springSceneVersion(-1), m_app(_app), m_selectedParticle(-1) 
 {
 
-    // Un shader minimaliste pour afficher les particules
-    m_particleShader.init(
-       // Nom du shader
-       "particle_shader",
-
-       // Shader pour particules
-       "#version 410\n"
-       "uniform mat4 modelViewProj;\n"
-       "uniform vec4 color;\n"
-       "in vec2 position;\n"
-       "void main() {\n"
-       "    gl_Position = modelViewProj * vec4(position.xy, -1, 1);\n"
-       "}",
-
-       // Shader pour fragments
-       "#version 410\n"
-       "uniform vec4 color;\n"
-       "out vec4 frag_color;\n"
-       "void main() {\n"
-       "    frag_color = color;\n"
-       "}"
-    );
+    // Un shader pour afficher les particules et un autre pour les ressorts,
+    // dont les tampons (positions et indices) sont distincts
+    m_particleShader.init("particle_shader", vertexShader, fragmentShader);
+    m_springShader.init("spring_shader", vertexShader, fragmentShader);
 
     // Initialise la géométrie pour un cercle
     static const int numPoints = 8;
@@ -80,6 +82,7 @@ ParticleSimGLCanvas::ParticleSimGLCanvas(ParticleSimApplication* _app)
 
 ParticleSimGLCanvas::~ParticleSimGLCanvas() {
     m_particleShader.free();
+    m_springShader.free();
 }
 
 void ParticleSimGLCanvas::drawGL()
@@ -87,51 +90,47 @@ void ParticleSimGLCanvas::drawGL()
   glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
   glDisable(GL_DEPTH_TEST);
 
-  m_particleShader.bind();
-  m_particleShader.setUniform("color", Eigen::Vector4f(1.0f, 0.0, 0.0f, 1.0f));
-
   // Matrice de projection orthographique
   const Matrix4f projMat = nanogui::ortho(0, width()-1, 0, height()-1, 0.1f, 1.0f);
-  const gti320::ParticleSystem& particleSystem = m_app->getParticleSystem();
-  const auto particles = particleSystem.getParticles();
-  const int numParticles = particles.size();
-
-  // Affichage des ressorts
-  const auto springs = particleSystem.getSprings();
-  const int numSprings = springs.size();
-  gti320::Vector<double, gti320::Dynamic> points(4 * numSprings);
-  for (int i = 0; i < numSprings; ++i)
+  // Dernier état publié par le fil de simulation, interpolé entre les deux
+  // derniers pas
+  const gti320::SimulationSnapshot& snapshot = m_app->getSnapshot();
+  snapshot.interpolatePositions(m_positions);
+  const auto& positions = m_positions;
+  const int numParticles = snapshot.getParticleCount();
+
+  // Affichage des ressorts : les indices de leurs extrémités ne changent
+  // qu'au chargement d'un modèle, les positions sont envoyées telles quelles
+  const int numSprings = snapshot.springs.size();
+  m_springShader.bind();
+  if (m_springSceneVersion != snapshot.sceneVersion)
     {
-      int index0 = springs[i].index0;
-      int index1 = springs[i].index1;
-
-      const gti320::Vector2d& pos0 = particles[index0].x;
-      const gti320::Vector2d& pos1 = particles[index1].x;
-
-      points(4 * i) = pos0(0);
-      points(4 * i + 1) = pos0(1);
-      points(4 * i + 2) = pos1(0);
-      points(4 * i + 3) = pos1(1);
+      uploadSpringIndices(snapshot.springs);
+      m_springSceneVersion = snapshot.sceneVersion;
+    }
+  if (numSprings > 0)
+    {
+      m_springShader.setUniform("modelViewProj", projMat);
+      m_springShader.setUniform("color", Eigen::Vector4f(0.0f, 0.0, 1.0f, 1.0f));
+      m_springShader.uploadAttrib("position", (uint32_t)positions.rows(), (int)2,
+                                  sizeof(double), GL_DOUBLE, false, positions.storage().data());
+      m_springShader.drawIndexed(GL_LINES, 0, numSprings);
     }
-  m_particleShader.setUniform("modelViewProj", projMat);
-  m_particleShader.setUniform("color", Eigen::Vector4f(0.0f, 0.0, 1.0f, 1.0f));
-  m_particleShader.uploadAttrib("position", (uint32_t)points.rows(), (int)2, 
-                                sizeof(double), GL_DOUBLE, false, points.storage().data());
-  m_particleShader.drawArray(GL_LINES, 0, points.rows() / 2);
 
   // Affichage des particules
+  m_particleShader.bind();
   m_particleShader.setUniform("color", Eigen::Vector4f(1.0f, 0.0, 0.0f, 1.0f));
   m_particleShader.uploadAttrib("position", (uint32_t)m_circle.rows(), (int)2,
       sizeof(double), GL_DOUBLE, false, m_circle.storage().data());
   for (int i = 0; i < numParticles; ++i)
   {
       Matrix4f modelMat = Matrix4f::Identity();
-      modelMat(0, 3) = particles[i].x(0);
-      modelMat(1, 3) = particles[i].x(1);
+      modelMat(0, 3) = positions(2 * i);
+      modelMat(1, 3) = positions(2 * i + 1);
       const Matrix4f mvp = projMat * modelMat;
       m_particleShader.setUniform("modelViewProj", mvp);
 
-      if (particles[i].fixed)
+      if (snapshot.fixed[i])
           m_particleShader.setUniform("color", Eigen::Vector4f(0.6f, 0.6f, 1.0f, 1.0f));
       else
           m_particleShader.setUniform("color", Eigen::Vector4f(1.0f, 0.0, 0.0f, 1.0f));
@@ -140,10 +139,9 @@ void ParticleSimGLCanvas::drawGL()
   }
 
   // Affichage du ressort déféni par la souris
-  if (m_selectedParticle)
+  if (m_selectedParticle >= 0 && m_selectedParticle < numParticles)
     {
-      const gti320::Vector2d p = m_selectedParticle->x;
-      const double coords[4] = { m_mousePos(0), m_mousePos(1), p(0), p(1) };
+      const double coords[4] = { m_mousePos(0), m_mousePos(1), positions(2 * m_selectedParticle), positions(2 * m_selectedParticle + 1) };
       m_particleShader.setUniform("modelViewProj", projMat);
       m_particleShader.setUniform("color", Eigen::Vector4f(0.0f, 1.0, 0.0f, 1.0f));
       m_particleShader.uploadAttrib("position", (uint32_t)4, (int)2, sizeof(double), 
@@ -153,6 +151,22 @@ void ParticleSimGLCanvas::drawGL()
 
 }
 
+void ParticleSimGLCanvas::uploadSpringIndices(const std::vector<gti320::Spring>& springs)
+{
+  std::vector<uint32_t> indices(2 * springs.size());
+  for (size_t i = 0; i < springs.size(); ++i)
+    {
+      indices[2 * i] = springs[i].index0;
+      indices[2 * i + 1] = springs[i].index1;
+    }
+
+  if (!indices.empty())
+    {
+      m_springShader.uploadAttrib("indices", (uint32_t)indices.size(), (int)1,
+                                  sizeof(uint32_t), GL_UNSIGNED_INT, true, indices.data());
+    }
+}
+
 bool ParticleSimGLCanvas::mouseButtonEvent(const Vector2i& p, int button, bool down, int modifiers)
 {
   if ( modifiers == GLFW_MOD_SHIFT )
@@ -160,11 +174,20 @@ bool ParticleSimGLCanvas::mouseButtonEvent(const Vector2i& p, int button, bool d
       if (button == GLFW_MOUSE_BUTTON_1 && down)
         {
           convertAndStoreMousePos(p);
-          m_selectedParticle = pickParticle(m_app->getParticleSystem().getParticles(), m_mousePos);
-          if (m_selectedParticle != nullptr)
+          m_selectedParticle = pickParticle(m_app->getSnapshot(), m_mousePos);
+          if (m_selectedParticle >= 0)
             {
-              m_selectedParticle->fixed = !(m_selectedParticle->fixed);
+              const int selected = m_selectedParticle;
+              m_app->getSimulation().post([selected](gti320::Simulator& simulator)
+                {
+                  gti320::ParticleSystem& particleSystem = simulator.getParticleSystem();
+                  if (selected < particleSystem.getParticleCount())
+                    {
+                      particleSystem.setFixed(selected, !particleSystem.isFixed(selected));
+                    }
+                });
             }
+          m_app->getSimulation().setMouseSpring(m_selectedParticle, m_mousePos);
           return true;
         }
     }
@@ -173,12 +196,14 @@ bool ParticleSimGLCanvas::mouseButtonEvent(const Vector2i& p, int button, bool d
       if (button == GLFW_MOUSE_BUTTON_1 && down)
         {
           convertAndStoreMousePos(p);
-          m_selectedParticle = pickParticle(m_app->getParticleSystem().getParticles(), m_mousePos);
+          m_selectedParticle = pickParticle(m_app->getSnapshot(), m_mousePos);
+          m_app->getSimulation().setMouseSpring(m_selectedParticle, m_mousePos);
           return true;
         }
       else if (button == 0)
         {
-          m_selectedParticle = nullptr;
+          m_selectedParticle = -1;
+          m_app->getSimulation().setMouseSpring(m_selectedParticle, m_mousePos);
           return true;
         }
     }
@@ -188,9 +213,10 @@ bool ParticleSimGLCanvas::mouseButtonEvent(const Vector2i& p, int button, bool d
 
 bool ParticleSimGLCanvas::mouseDragEvent(const Vector2i& p, const Vector2i & rel, int button, int modifiers)
 {
-  if (button == GLFW_MOUSE_BUTTON_2 && modifiers == 0 && m_selectedParticle != nullptr )
+  if (button == GLFW_MOUSE_BUTTON_2 && modifiers == 0 && m_selectedParticle >= 0 )
     {
       convertAndStoreMousePos(p);
+      m_app->getSimulation().setMouseSpring(m_selectedParticle, m_mousePos);
       return true;
     }
   return false;
@@ -203,13 +229,3 @@ void ParticleSimGLCanvas::convertAndStoreMousePos(const Vector2i & mousePos)
   m_mousePos(0) = (double)(mousePos.x() - pos.x());
   m_mousePos(1) = (double)y;
 }
-
-void ParticleSimGLCanvas::applyMouseSpring()
-{
-  if( m_selectedParticle != nullptr )
-    {
-      const double k = 20.0 * m_selectedParticle->m;
-      const gti320::Vector2d f = k * (m_mousePos - m_selectedParticle->x);
-      m_selectedParticle->f = m_selectedParticle->f + f;
-    }
-}
@@ -31,20 +31,25 @@ public:
 
   virtual bool mouseDragEvent(const Eigen::Vector2i &p, const Eigen::Vector2i &rel, int button, int modifiers) override;
 
-  void applyMouseSpring();
-
 private:
 
   void convertAndStoreMousePos(const Eigen::Vector2i& mousePos);
 
+  /**
+   * Envoie au shader des ressorts les indices de leurs extrémités
+   */
+  void uploadSpringIndices(const std::vector<gti320::Spring>& springs);
+
   nanogui::GLShader m_particleShader;
   nanogui::GLShader m_springShader;
+  int m_springSceneVersion; // modèle dont les indices des ressorts ont été envoyés
 
   ParticleSimApplication* m_app;
 
-  gti320::Particle* m_selectedParticle;
+  int m_selectedParticle; // indice de la particule sélectionnée, -1 si aucune
   double m_mouseStiffness;
   gti320::Vector2d m_mousePos;
   gti320::Vector<double> m_circle;
+  gti320::Vector<double, gti320::Dynamic> m_positions; // positions affichées
 
 };
@@ -9,164 +9,510 @@
  */
 
 #include "ParticleSystem.h"
+#include "Simd.h"
+
+#include <algorithm>
 
 using namespace gti320;
 
 const double ParticleSystem::gravitationalConstant = 9.81;
+const int ParticleSystem::parallelSpringThreshold = 16384;
 
-/**
- * Calcule des forces qui affectent chacune des particules.
- *
- * Étant donné une particule p, la force est stockée dans le vecteur p.f
- * Les forces prisent en compte sont : la gravité et la force des ressorts.
- */
-void ParticleSystem::computeForces()
+namespace
 {
-	// Calcul de la force gravitationnelle sur chacune des particules
-	for (Particle& particle : m_particles)
+	typedef simd::PacketOf<double>::Type SpringPacket;
+
+	// Nombre de ressorts évalués ensemble. Le lot couvre plusieurs registres
+	// SIMD : les positions rassemblées une à une dans le lot sont relues par
+	// paquets bien après avoir été écrites, sans attendre la fin des écritures.
+	constexpr int springBatchSize = 64;
+	static_assert(springBatchSize % SpringPacket::Width == 0, "The spring batch size must be a multiple of the packet width");
+
+	// Nombre de ressorts consécutifs d'une série (voir buildSpringColoring)
+	constexpr int springRunSize = 1024;
+
+	/**
+	 * Lot de ressorts rangé par tableaux : l'élément `lane` de chacun des
+	 * tableaux correspond au ressort `lane` du lot.
+	 */
+	struct SpringBatch
+	{
+		alignas(64) double dx[springBatchSize]; // x1 - x0
+		alignas(64) double dy[springBatchSize];
+		alignas(64) double k[springBatchSize];
+		alignas(64) double l0[springBatchSize];
+
+		alignas(64) double fx[springBatchSize]; // force exercée sur la particule 0
+		alignas(64) double fy[springBatchSize];
+		alignas(64) double dfdx00[springBatchSize]; // bloc de rigidité (symétrique)
+		alignas(64) double dfdx01[springBatchSize];
+		alignas(64) double dfdx11[springBatchSize];
+	};
+
+	/**
+	 * Calcule la force et le bloc de rigidité des ressorts d'un lot.
+	 *
+	 * Les opérations sont celles du calcul scalaire d'un ressort, dans le même
+	 * ordre : les résultats sont identiques.
+	 */
+	inline void evaluateSpringBatch(SpringBatch& batch)
 	{
-		particle.f.x() = 0.0;
-		particle.f.y() = -gravitationalConstant * particle.m;
+		typedef SpringPacket P;
+
+		for (auto lane = 0; lane < springBatchSize; lane += P::Width)
+		{
+			const auto dx = P::load(batch.dx + lane);
+			const auto dy = P::load(batch.dy + lane);
+			const auto k = P::load(batch.k + lane);
+			const auto l0 = P::load(batch.l0 + lane);
+
+			const auto squaredDistance = P::add(P::multiply(dx, dx), P::multiply(dy, dy));
+			const auto distance = P::squareRoot(squaredDistance);
+
+			const auto inverseDistance = P::divide(P::set(1.0), distance);
+			const auto force = P::multiply(k, P::subtract(distance, l0));
+
+			P::store(batch.fx + lane, P::multiply(P::multiply(dx, inverseDistance), force));
+			P::store(batch.fy + lane, P::multiply(P::multiply(dy, inverseDistance), force));
+
+			const auto alpha = P::multiply(k, P::subtract(P::set(1.0), P::divide(l0, distance)));
+			const auto beta = P::multiply(k, P::divide(l0, P::multiply(distance, squaredDistance)));
+
+			P::store(batch.dfdx00 + lane, P::add(P::multiply(P::multiply(dx, dx), beta), alpha));
+			P::store(batch.dfdx01 + lane, P::multiply(P::multiply(dx, dy), beta));
+			P::store(batch.dfdx11 + lane, P::add(P::multiply(P::multiply(dy, dy), beta), alpha));
+		}
 	}
 
-	// Calcul de la force de chaque ressort pour ses particules associées
-	for (const Spring& spring : m_springs)
+	/**
+	 * Évalue par lots les ressorts begin à end - 1, puis appelle
+	 * `scatter(springIndex, batch, lane)` pour chacun d'eux, dans l'ordre.
+	 *
+	 * Les positions des particules sont rassemblées dans le lot avant le
+	 * calcul; les résultats sont dispersés un ressort à la fois, ce qui permet
+	 * à deux ressorts d'un même lot de partager une particule.
+	 */
+	template <typename Scatter>
+	inline void forEachSpringBatch(const std::vector<Spring>& springs, int begin, int end, const double* positions, Scatter scatter)
 	{
-		auto& firstParticle = m_particles[spring.index0];
-		auto& secondParticle = m_particles[spring.index1];
-
-		auto differenceVector = secondParticle.x - firstParticle.x;
-		auto distance = differenceVector.norm();
-		auto direction = differenceVector * (1.0 / distance);
+		SpringBatch batch;
+		for (auto first = begin; first < end; first += springBatchSize)
+		{
+			const int count = std::min(springBatchSize, end - first);
+			for (auto lane = 0; lane < count; ++lane)
+			{
+				const Spring& spring = springs[first + lane];
+				batch.dx[lane] = positions[2 * spring.index1] - positions[2 * spring.index0];
+				batch.dy[lane] = positions[2 * spring.index1 + 1] - positions[2 * spring.index0 + 1];
+				batch.k[lane] = spring.k;
+				batch.l0[lane] = spring.l0;
+			}
+
+			// Éléments inutilisés du dernier lot : un ressort fictif qui ne divise pas par zéro
+			for (auto lane = count; lane < springBatchSize; ++lane)
+			{
+				batch.dx[lane] = 1.0;
+				batch.dy[lane] = 0.0;
+				batch.k[lane] = 0.0;
+				batch.l0[lane] = 0.0;
+			}
+
+			evaluateSpringBatch(batch);
+
+			for (auto lane = 0; lane < count; ++lane)
+			{
+				scatter(first + lane, batch, lane);
+			}
+		}
+	}
 
-		auto force = spring.k * (distance - spring.l0);
-		auto forceVector = direction * force;
+	/**
+	 * Ajoute la force d'un ressort aux forces de ses deux particules
+	 */
+	inline void addSpringForce(const Spring& spring, const SpringBatch& batch, int lane, double* forces)
+	{
+		forces[2 * spring.index0] = forces[2 * spring.index0] + batch.fx[lane];
+		forces[2 * spring.index0 + 1] = forces[2 * spring.index0 + 1] + batch.fy[lane];
+		forces[2 * spring.index1] = forces[2 * spring.index1] - batch.fx[lane];
+		forces[2 * spring.index1 + 1] = forces[2 * spring.index1 + 1] - batch.fy[lane];
+	}
 
-		firstParticle.f = firstParticle.f + forceVector;
-		secondParticle.f = secondParticle.f - forceVector;
+	/**
+	 * Ajoute le bloc de rigidité d'un ressort aux quatre blocs de df/dx qu'il
+	 * touche : (0, 0), (1, 1), (0, 1) et (1, 0)
+	 */
+	inline void addSpringStiffness(BlockSparseMatrix<double>& dfdx, const int* springBlocks, const SpringBatch& batch, int lane)
+	{
+		// Le bloc est symétrique : l'ordre de stockage (lignes ou colonnes) n'a pas d'importance
+		const double contribution[4] = { batch.dfdx00[lane], batch.dfdx01[lane], batch.dfdx01[lane], batch.dfdx11[lane] };
+
+		double* firstDiagonal = dfdx.block(springBlocks[0]);
+		double* secondDiagonal = dfdx.block(springBlocks[1]);
+		double* firstOffDiagonal = dfdx.block(springBlocks[2]);
+		double* secondOffDiagonal = dfdx.block(springBlocks[3]);
+
+		for (auto j = 0; j < 4; ++j)
+		{
+			firstDiagonal[j] -= contribution[j];
+			secondDiagonal[j] -= contribution[j];
+			firstOffDiagonal[j] += contribution[j];
+			secondOffDiagonal[j] += contribution[j];
+		}
 	}
 }
 
 /**
- * Assemble les données du système dans les vecteurs trois vecteurs d'état outPos,
- * outVel et outForce.
+ * Ajoute une particule à la fin des tableaux du système.
+ *
+ * La capacité des vecteurs d'état est doublée au besoin, de sorte que l'ajout
+ * de N particules se fait en temps linéaire.
  */
-void ParticleSystem::pack(Vector<double, Dynamic>& outPos,
-                          Vector<double, Dynamic>& outVel,
-                          Vector<double, Dynamic>& outForce)
+void ParticleSystem::addParticle(const Particle& particle)
 {
-	const int numberOfParticles = static_cast<int>(m_particles.size());
-	outPos.resize(numberOfParticles * 2);
-	outVel.resize(numberOfParticles * 2);
-	outForce.resize(numberOfParticles * 2);
-
-	for (auto i = 0; i < numberOfParticles; ++i)
+	const int index = getParticleCount();
+	if (index == static_cast<int>(m_masses.capacity()))
 	{
-		auto particle = m_particles[i];
+		const int capacity = std::max(8, 2 * index);
+		m_masses.reserve(capacity);
+		m_fixed.reserve(capacity);
+		m_positions.reserve(2 * capacity);
+		m_velocities.reserve(2 * capacity);
+		m_forces.reserve(2 * capacity);
+	}
+
+	m_positions.conservativeResize(2 * index + 2);
+	m_velocities.conservativeResize(2 * index + 2);
+	m_forces.conservativeResize(2 * index + 2);
 
-		outPos(2 * i) = particle.x.x();
-		outPos(2 * i + 1) = particle.x.y();
+	m_positions(2 * index) = particle.x.x();
+	m_positions(2 * index + 1) = particle.x.y();
+	m_velocities(2 * index) = particle.v.x();
+	m_velocities(2 * index + 1) = particle.v.y();
+	m_forces(2 * index) = particle.f.x();
+	m_forces(2 * index + 1) = particle.f.y();
 
-		outVel(2 * i) = particle.v.x();
-		outVel(2 * i + 1) = particle.v.y();
+	m_masses.push_back(particle.m);
+	m_fixed.push_back(particle.fixed);
+}
 
-		outForce(2 * i) = particle.f.x();
-		outForce(2 * i + 1) = particle.f.y();
+/**
+ * Calcule les forces et la matrice de rigidité creuse en un seul parcours.
+ *
+ * Les forces sont stockées dans le vecteur d'état des forces (voir getForces).
+ * Les forces prises en compte sont : la gravité et la force des ressorts.
+ */
+void ParticleSystem::computeForcesAndJacobian(BlockSparseMatrix<double>& outDfDxMatrix)
+{
+	const int numberOfParticles = getParticleCount();
+	if (outDfDxMatrix.blockRows() != numberOfParticles || m_springBlocks.size() != 4 * m_springs.size())
+	{
+		buildDfDxPattern(outDfDxMatrix);
 	}
+
+	outDfDxMatrix.setZero();
+	evaluateSprings(outDfDxMatrix);
 }
 
 /**
- * Copie les données des vecteurs d'états dans le particules du système.
+ * Calcul des forces et des blocs de df/dx.
  */
-void ParticleSystem::unpack(const Vector<double, Dynamic>& pos,
-                            const Vector<double, Dynamic>& vel)
+void ParticleSystem::evaluateSprings(BlockSparseMatrix<double>& outDfDxMatrix)
 {
-	ASSERTF(pos.size() == static_cast<int>(m_particles.size()) * 2, "Trying to unpack positions with a particle system of uncompatible size (%d vs %d)", pos.size(), static_cast<int>(m_particles.size()));
-	ASSERTF(vel.size() == static_cast<int>(m_particles.size()) * 2, "Trying to unpack velocities with a particle system of uncompatible size (%d vs %d)", vel.size(), static_cast<int>(m_particles.size()));
+	const int numberOfParticles = getParticleCount();
+	const double* positions = m_positions.data();
+	double* forces = m_forces.data();
 
-	for (auto i = 0; i < static_cast<int>(m_particles.size()); ++i)
+	// Calcul de la force gravitationnelle sur chacune des particules
+	for (auto i = 0; i < numberOfParticles; ++i)
 	{
-		auto& particle = m_particles[i];
+		forces[2 * i] = 0.0;
+		forces[2 * i + 1] = -gravitationalConstant * m_masses[i];
+	}
 
-		particle.x.x() = pos(2 * i);
-		particle.x.y() = pos(2 * i + 1);
+	// Calcul de la force et du bloc de rigidité de chaque ressort pour ses
+	// particules associées
+	const auto evaluateRange = [this, positions, forces, &outDfDxMatrix](int begin, int end)
+	{
+		forEachSpringBatch(m_springs, begin, end, positions,
+			[this, forces, &outDfDxMatrix](int springIndex, const SpringBatch& batch, int lane)
+			{
+				addSpringForce(m_springs[springIndex], batch, lane, forces);
+				addSpringStiffness(outDfDxMatrix, &m_springBlocks[4 * springIndex], batch, lane);
+			});
+	};
+
+	const int numberOfSprings = static_cast<int>(m_springs.size());
+	if (numberOfSprings < parallelSpringThreshold)
+	{
+		evaluateRange(0, numberOfSprings);
+		return;
+	}
+
+	// Chaque ressort écrit dans les forces et les blocs diagonaux de ses deux
+	// particules : les séries de ressorts d'une même couleur n'ont aucune
+	// particule en commun et sont donc traitées en parallèle, une couleur
+	// après l'autre. L'ordre des sommes ne dépend pas du nombre de fils
+	// d'exécution. Comme pour la structure de df/dx, la coloration est
+	// refaite lorsque le nombre de ressorts a changé (les ressorts peuvent
+	// être modifiés par getSprings).
+	if (m_springColorPointers.empty() || m_springColoringSize != numberOfSprings)
+	{
+		buildSpringColoring(springRunSize, m_springColorPointers, m_springColorRuns);
+		m_springColoringSize = numberOfSprings;
+	}
 
-		particle.v.x() = vel(2 * i);
-		particle.v.y() = vel(2 * i + 1);
+	const int numberOfColors = static_cast<int>(m_springColorPointers.size()) - 1;
+	#pragma omp parallel
+	{
+		for (auto color = 0; color < numberOfColors; ++color)
+		{
+			#pragma omp for schedule(static)
+			for (auto p = m_springColorPointers[color]; p < m_springColorPointers[color + 1]; ++p)
+			{
+				const int first = m_springColorRuns[p] * springRunSize;
+				evaluateRange(first, std::min(first + springRunSize, numberOfSprings));
+			}
+		}
 	}
 }
 
 
 /**
- * Construction de la matrice de masses.
+ * Construction de la matrice de masses diagonale.
+ *
+ * Seule la diagonale est stockée : la matrice est construite en temps linéaire.
  */
-void ParticleSystem::buildMassMatrix(Matrix<double, Dynamic, Dynamic>& outMassMatrix)
+void ParticleSystem::buildMassMatrix(DiagonalMatrix<double>& outMassMatrix)
 {
-	const int numberOfParticles = static_cast<int>(m_particles.size());
-	const int dimensions = 2 * numberOfParticles;
-	outMassMatrix.resize(dimensions, dimensions);
-	outMassMatrix.setZero();
+	const int numberOfParticles = getParticleCount();
+	outMassMatrix.resize(2 * numberOfParticles);
 
 	for (int i = 0; i < numberOfParticles; ++i)
 	{
-		auto particle = m_particles[i];
-		auto particleMass = !particle.fixed ? particle.m : std::numeric_limits<double>::max();
+		auto particleMass = !m_fixed[i] ? m_masses[i] : std::numeric_limits<double>::max();
 
-		outMassMatrix(2 * i, 2 * i) = particleMass;
-		outMassMatrix(2 * i + 1, 2 * i + 1) = particleMass;
+		outMassMatrix(2 * i) = particleMass;
+		outMassMatrix(2 * i + 1) = particleMass;
 	}
 }
 
 
 /**
- * Construction de la matrice de rigidité.
+ * Construction de la structure de la matrice de rigidité creuse.
+ *
+ * Chaque ressort relie deux particules et touche donc quatre blocs 2x2 de la
+ * matrice. L'indice de ces blocs est conservé afin que l'assemblage des
+ * valeurs n'ait pas à faire de recherche dans la structure.
  */
-void ParticleSystem::buildDfDx(Matrix<double, Dynamic, Dynamic>& outDfDxMatrix)
+void ParticleSystem::buildDfDxPattern(BlockSparseMatrix<double>& outDfDxMatrix)
 {
-	const int numberOfParticles = m_particles.size();
-	const int dimensions = 2 * numberOfParticles;
-	outDfDxMatrix.resize(dimensions, dimensions);
-	outDfDxMatrix.setZero();
+	const int numberOfParticles = getParticleCount();
 
-	// Pour chaque ressort...
+	std::vector<std::pair<int, int>> blocks;
+	blocks.reserve(2 * m_springs.size());
 	for (const Spring& spring : m_springs)
 	{
-		auto firstParticle = m_particles[spring.index0];
-		auto secondParticle = m_particles[spring.index1];
+		blocks.emplace_back(spring.index0, spring.index1);
+		blocks.emplace_back(spring.index1, spring.index0);
+	}
+
+	outDfDxMatrix.setPattern(numberOfParticles, blocks);
+
+	m_springBlocks.resize(4 * m_springs.size());
+	for (auto i = 0; i < static_cast<int>(m_springs.size()); ++i)
+	{
+		const Spring& spring = m_springs[i];
+
+		m_springBlocks[4 * i] = outDfDxMatrix.diagonalBlock(spring.index0);
+		m_springBlocks[4 * i + 1] = outDfDxMatrix.diagonalBlock(spring.index1);
+		m_springBlocks[4 * i + 2] = outDfDxMatrix.findBlock(spring.index0, spring.index1);
+		m_springBlocks[4 * i + 3] = outDfDxMatrix.findBlock(spring.index1, spring.index0);
+	}
 
-		auto differenceVector = secondParticle.x - firstParticle.x;
-		auto squaredDistance = differenceVector.squaredNorm();
-		auto distance = sqrt(squaredDistance);
+	buildColoring(m_colorPointers, m_colorParticles);
+}
 
-		auto springContribution = this->dyadicProduct(differenceVector, differenceVector);
+/**
+ * Coloration gloutonne du graphe des ressorts.
+ *
+ * Chaque particule reçoit la plus petite couleur qui n'est utilisée par aucune
+ * de ses voisines. Les particules d'une même couleur ne partagent donc aucun
+ * bloc hors diagonale de df/dx et peuvent être traitées en parallèle.
+ */
+void ParticleSystem::buildColoring(std::vector<int>& outColorPointers, std::vector<int>& outColorParticles) const
+{
+	const int numberOfParticles = getParticleCount();
 
-		auto alphaCoefficient = spring.k * (1.0 - (spring.l0 / distance));
-		auto dyadicProductCoefficient = spring.k * (spring.l0 / (distance * squaredDistance));
+	// Liste d'adjacence compacte des particules
+	std::vector<int> neighborPointers(numberOfParticles + 1, 0);
+	for (const Spring& spring : m_springs)
+	{
+		++neighborPointers[spring.index0 + 1];
+		++neighborPointers[spring.index1 + 1];
+	}
+	for (auto i = 0; i < numberOfParticles; ++i)
+	{
+		neighborPointers[i + 1] += neighborPointers[i];
+	}
 
-		springContribution(0, 0) = springContribution(0, 0) * dyadicProductCoefficient + alphaCoefficient;
-		springContribution(1, 1) = springContribution(1, 1) * dyadicProductCoefficient + alphaCoefficient;
-		springContribution(0, 1) = springContribution(0, 1) * dyadicProductCoefficient;
-		springContribution(1, 0) = springContribution(1, 0) * dyadicProductCoefficient;
+	std::vector<int> neighbors(neighborPointers[numberOfParticles]);
+	std::vector<int> next(neighborPointers.begin(), neighborPointers.end() - 1);
+	for (const Spring& spring : m_springs)
+	{
+		neighbors[next[spring.index0]++] = spring.index1;
+		neighbors[next[spring.index1]++] = spring.index0;
+	}
 
-		// On ajoute la contribution à la diagonale
-		outDfDxMatrix.block(spring.index0 * 2, spring.index0 * 2, 2, 2) -= springContribution;
-		outDfDxMatrix.block(spring.index1 * 2, spring.index1 * 2, 2, 2) -= springContribution;
+	// colorUsedBy[c] == i lorsque la couleur c est utilisée par une voisine de i
+	std::vector<int> colors(numberOfParticles, -1);
+	std::vector<int> colorUsedBy;
+	auto numberOfColors = 0;
+	for (auto i = 0; i < numberOfParticles; ++i)
+	{
+		for (auto p = neighborPointers[i]; p < neighborPointers[i + 1]; ++p)
+		{
+			const auto neighborColor = colors[neighbors[p]];
+			if (neighborColor >= 0)
+			{
+				colorUsedBy[neighborColor] = i;
+			}
+		}
+
+		auto color = 0;
+		while (color < numberOfColors && colorUsedBy[color] == i)
+		{
+			++color;
+		}
+
+		if (color == numberOfColors)
+		{
+			colorUsedBy.push_back(-1);
+			++numberOfColors;
+		}
+		colors[i] = color;
+	}
 
-		// On ajoute la contribution négative aux autres endroits de la matrice
-		outDfDxMatrix.block(spring.index0 * 2, spring.index1 * 2, 2, 2) = springContribution;
-		outDfDxMatrix.block(spring.index1 * 2, spring.index0 * 2, 2, 2) = springContribution;
+	// Regroupement des particules par couleur
+	outColorPointers.assign(numberOfColors + 1, 0);
+	for (auto i = 0; i < numberOfParticles; ++i)
+	{
+		++outColorPointers[colors[i] + 1];
+	}
+	for (auto color = 0; color < numberOfColors; ++color)
+	{
+		outColorPointers[color + 1] += outColorPointers[color];
+	}
+
+	outColorParticles.resize(numberOfParticles);
+	next.assign(outColorPointers.begin(), outColorPointers.end() - 1);
+	for (auto i = 0; i < numberOfParticles; ++i)
+	{
+		outColorParticles[next[colors[i]]++] = i;
 	}
 }
 
-Matrix<double, 2, 2> ParticleSystem::dyadicProduct(const Vector2d& left, const Vector2d& right) const
+/**
+ * Coloration gloutonne des séries de ressorts consécutifs.
+ *
+ * Les ressorts sont regroupés en séries de `runSize` ressorts consécutifs.
+ * Chaque série reçoit la plus petite couleur qu'aucune autre série touchant
+ * l'une de ses particules n'utilise déjà. Une série est ensuite traitée d'un
+ * seul tenant, dans l'ordre des ressorts : les accès aux particules restent
+ * aussi locaux que dans une boucle séquentielle.
+ */
+void ParticleSystem::buildSpringColoring(int runSize, std::vector<int>& outColorPointers, std::vector<int>& outColorRuns) const
 {
-	Matrix<double, 2, 2> dyadicProduct;
+	const int numberOfParticles = getParticleCount();
+	const int numberOfSprings = static_cast<int>(m_springs.size());
+	const int numberOfRuns = (numberOfSprings + runSize - 1) / runSize;
+
+	// Séries qui touchent chacune des particules (liste d'adjacence compacte).
+	// Les ressorts sont parcourus dans l'ordre : une série n'est ajoutée
+	// qu'une fois à une particule.
+	std::vector<int> lastRun(numberOfParticles, -1);
+	std::vector<int> runPointers(numberOfParticles + 1, 0);
+	for (auto s = 0; s < numberOfSprings; ++s)
+	{
+		for (const int particle : { m_springs[s].index0, m_springs[s].index1 })
+		{
+			if (lastRun[particle] != s / runSize)
+			{
+				lastRun[particle] = s / runSize;
+				++runPointers[particle + 1];
+			}
+		}
+	}
+	for (auto i = 0; i < numberOfParticles; ++i)
+	{
+		runPointers[i + 1] += runPointers[i];
+	}
 
-	dyadicProduct(0, 0) = left.x() * right.x();
-	dyadicProduct(0, 1) = left.x() * right.y();
+	std::vector<int> particleRuns(runPointers[numberOfParticles]);
+	std::vector<int> next(runPointers.begin(), runPointers.end() - 1);
+	lastRun.assign(numberOfParticles, -1);
+	for (auto s = 0; s < numberOfSprings; ++s)
+	{
+		for (const int particle : { m_springs[s].index0, m_springs[s].index1 })
+		{
+			if (lastRun[particle] != s / runSize)
+			{
+				lastRun[particle] = s / runSize;
+				particleRuns[next[particle]++] = s / runSize;
+			}
+		}
+	}
 
-	dyadicProduct(1, 0) = left.y() * right.x();
-	dyadicProduct(1, 1) = left.y() * right.y();
+	// colorUsedBy[c] == r lorsque la couleur c est utilisée par une série voisine de r
+	std::vector<int> colors(numberOfRuns, -1);
+	std::vector<int> colorUsedBy;
+	auto numberOfColors = 0;
+	for (auto r = 0; r < numberOfRuns; ++r)
+	{
+		const int end = std::min((r + 1) * runSize, numberOfSprings);
+		for (auto s = r * runSize; s < end; ++s)
+		{
+			for (const int particle : { m_springs[s].index0, m_springs[s].index1 })
+			{
+				for (auto p = runPointers[particle]; p < runPointers[particle + 1]; ++p)
+				{
+					const auto neighborColor = colors[particleRuns[p]];
+					if (neighborColor >= 0)
+					{
+						colorUsedBy[neighborColor] = r;
+					}
+				}
+			}
+		}
+
+		auto color = 0;
+		while (color < numberOfColors && colorUsedBy[color] == r)
+		{
+			++color;
+		}
+
+		if (color == numberOfColors)
+		{
+			colorUsedBy.push_back(-1);
+			++numberOfColors;
+		}
+		colors[r] = color;
+	}
 
-	return dyadicProduct;
+	// Regroupement des séries par couleur
+	outColorPointers.assign(numberOfColors + 1, 0);
+	for (auto r = 0; r < numberOfRuns; ++r)
+	{
+		++outColorPointers[colors[r] + 1];
+	}
+	for (auto color = 0; color < numberOfColors; ++color)
+	{
+		outColorPointers[color + 1] += outColorPointers[color];
+	}
+
+	outColorRuns.resize(numberOfRuns);
+	next.assign(outColorPointers.begin(), outColorPointers.end() - 1);
+	for (auto r = 0; r < numberOfRuns; ++r)
+	{
+		outColorRuns[next[colors[r]]++] = r;
+	}
 }
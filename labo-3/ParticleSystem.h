@@ -11,6 +11,8 @@
  */
 
 #include "Math3D.h"
+#include "BlockSparseMatrix.h"
+#include "DiagonalMatrix.h"
 #include "Vector2d.h"
 #include <vector>
 
@@ -18,6 +20,10 @@ namespace gti320
 {
 	/**
 	 * Classe particule 2D.
+	 *
+	 * Décrit une particule à ajouter au système (voir ParticleSystem::addParticle).
+	 * Une fois ajoutées, les données des particules sont stockées par tableaux
+	 * dans le système et sont accessibles par ParticleRef.
 	 */
 	class Particle
 	{
@@ -59,19 +65,50 @@ namespace gti320
 		}
 	};
 
+	class ParticleRef;
+
 	/**
 	 * Classe représentant un système de particule masse-ressort 2D.
+	 *
+	 * Les particules sont stockées par tableaux (structure of arrays) : les
+	 * positions, les vitesses et les forces sont des vecteurs de taille 2N où
+	 * les coordonnées sont entrelacées (x0, y0, x1, y1, ...). Ce sont
+	 * directement les vecteurs d'état de l'intégrateur et des solveurs; aucune
+	 * copie n'est nécessaire entre les particules et les vecteurs d'état.
 	 */
 	class ParticleSystem
 	{
 	private:
 		static const double gravitationalConstant;
+		static const int parallelSpringThreshold; // nombre de ressorts à partir duquel les forces sont calculées en parallèle
+
+		Vector<double, Dynamic> m_positions; // positions des particules
+		Vector<double, Dynamic> m_velocities; // vitesses des particules
+		Vector<double, Dynamic> m_forces; // forces exercées sur les particules
+		std::vector<double> m_masses; // masses des particules
+		std::vector<char> m_fixed; // indique si une particule est stationnaire (impossible à bouger)
 
-		std::vector<Particle> m_particles; // les particules
 		std::vector<Spring> m_springs; // les ressorts
 
+		// Indices des blocs de la matrice df/dx creuse associés à chacun des
+		// ressorts : (0, 0), (1, 1), (0, 1) et (1, 0)
+		std::vector<int> m_springBlocks;
+
+		// Coloration des particules : les particules de la couleur c sont
+		// m_colorParticles[m_colorPointers[c]..m_colorPointers[c + 1][
+		std::vector<int> m_colorPointers;
+		std::vector<int> m_colorParticles;
+
+		// Coloration des séries de ressorts consécutifs (voir buildSpringColoring) :
+		// deux séries d'une même couleur ne partagent aucune particule. Les
+		// séries de la couleur c sont
+		// m_springColorRuns[m_springColorPointers[c]..m_springColorPointers[c + 1][
+		std::vector<int> m_springColorPointers;
+		std::vector<int> m_springColorRuns;
+		int m_springColoringSize; // nombre de ressorts pour lequel la coloration a été construite
+
 	public:
-		ParticleSystem() : m_particles(), m_springs()
+		ParticleSystem() : m_positions(), m_velocities(), m_forces(), m_masses(), m_fixed(), m_springs(), m_springBlocks(), m_colorPointers(), m_colorParticles(), m_springColorPointers(), m_springColorRuns(), m_springColoringSize(0)
 		{
 		}
 
@@ -80,43 +117,82 @@ namespace gti320
 		 */
 		void clear()
 		{
-			m_particles.clear();
+			m_positions.resize(0);
+			m_velocities.resize(0);
+			m_forces.resize(0);
+			m_masses.clear();
+			m_fixed.clear();
 			m_springs.clear();
+			m_springBlocks.clear();
+			m_colorPointers.clear();
+			m_colorParticles.clear();
+			m_springColorPointers.clear();
+			m_springColorRuns.clear();
+			m_springColoringSize = 0;
 		}
 
 		/**
-		 * Ajoute une particule au système. La particule est copiée dans le tableau
-		 * m_particles.
+		 * Ajoute une particule au système. Ses données sont copiées à la fin des
+		 * tableaux de particules.
 		 */
-		void addParticle(const Particle& particle)
-		{
-			m_particles.push_back(particle);
-		}
+		void addParticle(const Particle& particle);
 
 		/**
 		 * Ajoute un ressort au système. Le ressort est copié dans le tableau
 		 * m_springs.
 		 */
-		void addSpring(const Spring& spring) { m_springs.push_back(spring); }
+		void addSpring(const Spring& spring)
+		{
+			m_springs.push_back(spring);
+			m_springColorPointers.clear(); // la coloration des ressorts doit être refaite
+		}
 
 		/**
-		 * Calcul des forces exercées sur chacune des particules.
+		 * Calcule les forces exercées sur chacune des particules (gravité et
+		 * ressorts) et la matrice df/dx creuse en un seul parcours des
+		 * ressorts : la différence des positions et la longueur de chaque
+		 * ressort ne sont calculées qu'une fois. Seules les valeurs des blocs
+		 * sont calculées; la structure de df/dx est construite au besoin.
+		 *
+		 * Les ressorts sont évalués par lots avec les instructions vectorielles.
+		 * Lorsque le système compte beaucoup de ressorts, ceux-ci sont traités
+		 * en parallèle, une couleur à la fois (voir buildSpringColoring).
 		 */
-		void computeForces();
+		void computeForcesAndJacobian(BlockSparseMatrix<double>& outDfDxMatrix);
 
 		/**
-		 * Accesseurs pour les particules et les ressorts
+		 * Nombre de particules du système
 		 */
-		const std::vector<Particle>& getParticles() const
-		{
-			return m_particles;
-		}
+		inline int getParticleCount() const { return static_cast<int>(m_masses.size()); }
 
-		std::vector<Particle>& getParticles()
-		{
-			return m_particles;
-		}
+		/**
+		 * Accès à la particule d'indice `index` (sans copie, voir ParticleRef)
+		 */
+		ParticleRef getParticle(int index);
+
+		/**
+		 * Vecteurs d'état (taille 2N, coordonnées entrelacées). Ils peuvent être
+		 * passés directement aux solveurs et modifiés sur place.
+		 */
+		const Vector<double, Dynamic>& getPositions() const { return m_positions; }
+		Vector<double, Dynamic>& getPositions() { return m_positions; }
+
+		const Vector<double, Dynamic>& getVelocities() const { return m_velocities; }
+		Vector<double, Dynamic>& getVelocities() { return m_velocities; }
 
+		const Vector<double, Dynamic>& getForces() const { return m_forces; }
+		Vector<double, Dynamic>& getForces() { return m_forces; }
+
+		/**
+		 * Masse et état stationnaire des particules
+		 */
+		inline double getMass(int index) const { return m_masses[index]; }
+		inline bool isFixed(int index) const { return m_fixed[index] != 0; }
+		inline void setFixed(int index, bool fixed) { m_fixed[index] = fixed; }
+
+		/**
+		 * Accesseurs pour les ressorts
+		 */
 		const std::vector<Spring>& getSprings() const
 		{
 			return m_springs;
@@ -128,30 +204,103 @@ namespace gti320
 		}
 
 		/**
-		 * Assemble les vecteurs d'états.
+		 * Contruit la matrice de masse sous forme diagonale.
 		 */
-		void pack(Vector<double, Dynamic>& outPos,
-		          Vector<double, Dynamic>& outVel,
-		          Vector<double, Dynamic>& outForce);
+		void buildMassMatrix(DiagonalMatrix<double>& outMassMatrix);
 
 		/**
-		 * Mise à jour de la position et de la vitesse de chacune des particules à
-		 * partir des vecteurs d'état.
+		 * Construit la structure de la matrice df/dx creuse à partir des ressorts.
+		 *
+		 * La structure ne dépend que de la topologie du système et n'a besoin
+		 * d'être reconstruite que lorsque des particules ou des ressorts sont
+		 * ajoutés ou retirés.
 		 */
-		void unpack(const Vector<double, Dynamic>& pos,
-		            const Vector<double, Dynamic>& vel);
+		void buildDfDxPattern(BlockSparseMatrix<double>& outDfDxMatrix);
 
 		/**
-		 * Contruit la matrice de masse.
+		 * Colore les particules de façon à ce que deux particules reliées par un
+		 * ressort n'aient jamais la même couleur (coloration gloutonne).
+		 *
+		 * Les particules de la couleur c sont
+		 * outColorParticles[outColorPointers[c]..outColorPointers[c + 1][.
 		 */
-		void buildMassMatrix(Matrix<double, Dynamic, Dynamic>& outMassMatrix);
+		void buildColoring(std::vector<int>& outColorPointers, std::vector<int>& outColorParticles) const;
 
 		/**
-		 * Construit la matrice df/dx
+		 * Coloration des particules correspondant à la structure courante de
+		 * df/dx. Elle est mise à jour en même temps que cette structure.
 		 */
-		void buildDfDx(Matrix<double, Dynamic, Dynamic>& outDfDxMatrix);
+		const std::vector<int>& getColorPointers() const { return m_colorPointers; }
+		const std::vector<int>& getColorParticles() const { return m_colorParticles; }
 
 	private:
-		Matrix<double, 2, 2> dyadicProduct(const Vector2d & left, const Vector2d & right) const;
+		/**
+		 * Calcule les forces et les blocs de la matrice df/dx, dont la
+		 * structure est à jour.
+		 */
+		void evaluateSprings(BlockSparseMatrix<double>& outDfDxMatrix);
+
+		/**
+		 * Coloration gloutonne des séries de `runSize` ressorts consécutifs :
+		 * les séries d'une même couleur ne partagent aucune particule et leurs
+		 * forces peuvent être accumulées en parallèle sans conflit d'écriture.
+		 */
+		void buildSpringColoring(int runSize, std::vector<int>& outColorPointers, std::vector<int>& outColorRuns) const;
 	};
+
+	/**
+	 * Mandataire donnant accès aux données d'une particule d'un système.
+	 *
+	 * Il remplace l'accès direct aux objets Particle : les lectures et les
+	 * écritures se font dans les tableaux du système. Il reste valide tant que
+	 * des particules ne sont pas ajoutées ou retirées.
+	 */
+	class ParticleRef
+	{
+	private:
+		ParticleSystem* m_system;
+		int m_index;
+
+	public:
+		ParticleRef(ParticleSystem& system, int index) : m_system(&system), m_index(index)
+		{
+		}
+
+		inline int index() const { return m_index; }
+
+		inline Vector2d x() const { return Vector2d(m_system->getPositions()(2 * m_index), m_system->getPositions()(2 * m_index + 1)); }
+		inline Vector2d v() const { return Vector2d(m_system->getVelocities()(2 * m_index), m_system->getVelocities()(2 * m_index + 1)); }
+		inline Vector2d f() const { return Vector2d(m_system->getForces()(2 * m_index), m_system->getForces()(2 * m_index + 1)); }
+		inline double m() const { return m_system->getMass(m_index); }
+		inline bool fixed() const { return m_system->isFixed(m_index); }
+
+		inline void setX(const Vector2d& x)
+		{
+			m_system->getPositions()(2 * m_index) = x(0);
+			m_system->getPositions()(2 * m_index + 1) = x(1);
+		}
+
+		inline void setV(const Vector2d& v)
+		{
+			m_system->getVelocities()(2 * m_index) = v(0);
+			m_system->getVelocities()(2 * m_index + 1) = v(1);
+		}
+
+		inline void setFixed(bool fixed) { m_system->setFixed(m_index, fixed); }
+
+		/**
+		 * Ajoute une force à celles exercées sur la particule
+		 */
+		inline void addForce(const Vector2d& force)
+		{
+			m_system->getForces()(2 * m_index) += force(0);
+			m_system->getForces()(2 * m_index + 1) += force(1);
+		}
+	};
+
+	inline ParticleRef ParticleSystem::getParticle(int index)
+	{
+		ASSERT(index >= 0 && index < getParticleCount(), "Trying to access a particle out of range");
+		return ParticleRef(*this, index);
+	}
 }
@@ -0,0 +1,133 @@
+/**
+ * @file Profiler.cpp
+ *
+ * @brief Mesure du temps passé dans chacune des étapes d'un pas de
+ * simulation : chronomètres de portée et statistiques glissantes.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace gti320;
+
+TimingStats::TimingStats(int windowSize)
+	: m_samples(std::max(windowSize, 1), 0.0), m_next(0), m_count(0), m_total(0.0), m_totalCount(0), m_sorted()
+{
+}
+
+void TimingStats::add(double seconds)
+{
+	m_samples[m_next] = seconds;
+	m_next = (m_next + 1) % static_cast<int>(m_samples.size());
+	m_count = std::min(m_count + 1, static_cast<int>(m_samples.size()));
+	m_total += seconds;
+	++m_totalCount;
+}
+
+void TimingStats::setWindowSize(int windowSize)
+{
+	m_samples.assign(std::max(windowSize, 1), 0.0);
+	clear();
+}
+
+void TimingStats::clear()
+{
+	m_next = 0;
+	m_count = 0;
+	m_total = 0.0;
+	m_totalCount = 0;
+}
+
+/**
+ * Les m_count mesures de la fenêtre sont toujours les premières du tableau
+ * (fenêtre incomplète) ou tout le tableau : leur ordre n'a pas d'importance.
+ */
+double TimingStats::min() const
+{
+	if (m_count == 0)
+	{
+		return 0.0;
+	}
+	return *std::min_element(m_samples.begin(), m_samples.begin() + m_count);
+}
+
+double TimingStats::mean() const
+{
+	if (m_count == 0)
+	{
+		return 0.0;
+	}
+
+	double sum = 0.0;
+	for (int i = 0; i < m_count; ++i)
+	{
+		sum += m_samples[i];
+	}
+	return sum / m_count;
+}
+
+double TimingStats::percentile(double p) const
+{
+	if (m_count == 0)
+	{
+		return 0.0;
+	}
+
+	// Plus petite mesure telle qu'au moins une fraction p des mesures lui est
+	// inférieure ou égale
+	const int rank = std::min(std::max(static_cast<int>(std::ceil(p * m_count)) - 1, 0), m_count - 1);
+	m_sorted.assign(m_samples.begin(), m_samples.begin() + m_count);
+	std::nth_element(m_sorted.begin(), m_sorted.begin() + rank, m_sorted.end());
+	return m_sorted[rank];
+}
+
+TimingSummary TimingStats::summarize() const
+{
+	TimingSummary summary;
+	summary.count = m_count;
+	summary.min = min();
+	summary.mean = mean();
+	summary.p99 = percentile(0.99);
+	return summary;
+}
+
+void StepProfiler::setWindowSize(int windowSize)
+{
+	for (TimingStats& stats : m_phases)
+	{
+		stats.setWindowSize(windowSize);
+	}
+	m_step.setWindowSize(windowSize);
+}
+
+void StepProfiler::clear()
+{
+	for (TimingStats& stats : m_phases)
+	{
+		stats.clear();
+	}
+	m_step.clear();
+}
+
+StepProfile StepProfiler::summarize() const
+{
+	StepProfile profile;
+	for (int phase = 0; phase < kNumberOfStepPhases; ++phase)
+	{
+		profile.phases[phase] = m_phases[phase].summarize();
+	}
+	profile.step = m_step.summarize();
+	return profile;
+}
+
+const char* StepProfiler::getPhaseName(eStepPhase phase)
+{
+	static const char* const names[kNumberOfStepPhases] = { "mass matrix", "forces + df/dx", "assembly (A, b)", "solve", "integration" };
+	return names[phase];
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+/**
+ * @file Profiler.h
+ *
+ * @brief Mesure du temps passé dans chacune des étapes d'un pas de
+ * simulation : chronomètres de portée et statistiques glissantes.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <omp.h>
+
+#include <vector>
+
+namespace gti320
+{
+	// Étapes d'un pas de simulation
+	enum eStepPhase { kMassPhase, kForcesPhase, kAssemblyPhase, kSolvePhase, kIntegrationPhase, kNumberOfStepPhases };
+
+	/**
+	 * Résumé des durées d'une étape, en secondes
+	 */
+	struct TimingSummary
+	{
+		int count = 0;     // nombre de mesures dans la fenêtre
+		double min = 0.0;
+		double mean = 0.0;
+		double p99 = 0.0;  // 99e centile
+	};
+
+	/**
+	 * Résumé de toutes les étapes et du pas complet
+	 */
+	struct StepProfile
+	{
+		TimingSummary phases[kNumberOfStepPhases];
+		TimingSummary step;
+	};
+
+	/**
+	 * Statistiques des durées d'une étape sur les `windowSize` dernières
+	 * mesures (minimum, moyenne, centiles), ainsi que le temps total depuis la
+	 * dernière remise à zéro.
+	 */
+	class TimingStats
+	{
+	private:
+		std::vector<double> m_samples;      // fenêtre circulaire des dernières mesures
+		int m_next;                         // position de la prochaine mesure dans la fenêtre
+		int m_count;                        // nombre de mesures dans la fenêtre
+		double m_total;                     // somme de toutes les mesures
+		long long m_totalCount;             // nombre total de mesures
+		mutable std::vector<double> m_sorted; // copie de travail pour les centiles
+
+	public:
+		explicit TimingStats(int windowSize = 256);
+
+		/**
+		 * Ajoute une mesure, en secondes
+		 */
+		void add(double seconds);
+
+		/**
+		 * Taille de la fenêtre des statistiques glissantes. Les mesures
+		 * actuelles sont effacées.
+		 */
+		void setWindowSize(int windowSize);
+
+		void clear();
+
+		inline int count() const { return m_count; }
+		inline double total() const { return m_total; }
+		inline long long totalCount() const { return m_totalCount; }
+
+		double min() const;
+		double mean() const;
+
+		/**
+		 * Centile p (entre 0 et 1) des mesures de la fenêtre
+		 */
+		double percentile(double p) const;
+
+		TimingSummary summarize() const;
+	};
+
+	/**
+	 * Chronomètre de portée : ajoute à `stats` le temps écoulé entre sa
+	 * construction et sa destruction.
+	 */
+	class ScopedTimer
+	{
+	private:
+		TimingStats& m_stats;
+		const double m_start;
+
+	public:
+		explicit ScopedTimer(TimingStats& stats) : m_stats(stats), m_start(omp_get_wtime())
+		{
+		}
+
+		~ScopedTimer()
+		{
+			m_stats.add(omp_get_wtime() - m_start);
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+	};
+
+	/**
+	 * Statistiques de chacune des étapes d'un pas et du pas complet
+	 */
+	class StepProfiler
+	{
+	private:
+		TimingStats m_phases[kNumberOfStepPhases];
+		TimingStats m_step;
+
+	public:
+		TimingStats& phase(eStepPhase phase) { return m_phases[phase]; }
+		const TimingStats& phase(eStepPhase phase) const { return m_phases[phase]; }
+
+		TimingStats& step() { return m_step; }
+		const TimingStats& step() const { return m_step; }
+
+		void setWindowSize(int windowSize);
+
+		void clear();
+
+		StepProfile summarize() const;
+
+		/**
+		 * Nom d'une étape, pour l'affichage
+		 */
+		static const char* getPhaseName(eStepPhase phase);
+	};
+}
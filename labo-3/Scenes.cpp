@@ -0,0 +1,217 @@
+/**
+ * @file Scenes.cpp
+ *
+ * @brief Modèles masse-ressort prédéfinis
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include "Scenes.h"
+
+#include <cmath>
+
+using namespace gti320;
+
+/**
+ * Crée un système masse-ressort qui simule un tissu suspendu de N x N particules
+ */
+void gti320::createHangingCloth(ParticleSystem& particleSystem, double k, int N)
+{
+	particleSystem.clear();
+
+	const int x_start = 240;
+	const int y_start = 100;
+	const int dx = 32;
+	const int dy = 32;
+
+	int index = 0;
+	for (int i = 0; i < N; ++i)
+	{
+		for (int j = 0; j < N; ++j)
+		{
+			const int x = x_start + j * dx;
+			const int y = y_start + i * dy;
+
+			Particle particle(Vector2d(x, y), Vector2d(0, 0), Vector2d(0, 0), 1.0);
+			if (j == 0 && i == (N - 1)) particle.fixed = true;
+			if (j == (N - 1) && i == (N - 1)) particle.fixed = true;
+			particleSystem.addParticle(particle);
+
+			if (i > 0)
+			{
+				Spring s(index - N, index, k, (double)dy);
+				particleSystem.addSpring(s);
+			}
+			if (j > 0)
+			{
+				Spring s(index - 1, index, k, (double)dx);
+				particleSystem.addSpring(s);
+			}
+
+			if (i > 0 && j > 0)
+			{
+				Spring s(index - N - 1, index, k, std::sqrt((double)dx * dx + (double)dy * dy));
+				particleSystem.addSpring(s);
+			}
+			++index;
+		}
+	}
+}
+
+/**
+ * Crée un système masse-ressort qui simule une corde suspendu par ses
+ * extrémités.
+ */
+void gti320::createHangingRope(ParticleSystem& particleSystem, double k)
+{
+	particleSystem.clear();
+
+	const int N = 20;
+	const int x_start = 200;
+	const int dx = 32;
+
+	int index = 0;
+	for (int j = 0; j < N; ++j)
+	{
+		const int x = x_start + j * dx;
+		const int y = 480;
+
+		Particle particle(Vector2d(x, y), Vector2d(0, 0), Vector2d(0, 0), 1.0);
+		particle.fixed = (index == 0) || (index == N - 1);
+		particleSystem.addParticle(particle);
+		if (j > 0)
+		{
+			Spring s(index - 1, index, k, (double)dx);
+			particleSystem.addSpring(s);
+		}
+		++index;
+	}
+}
+
+/**
+ * Crée un système masse-ressort qui simule une poutre flexible
+ */
+void gti320::createBeam(ParticleSystem& particleSystem, double k)
+{
+	particleSystem.clear();
+
+	const int N = 20;
+	const int x_start = 200;
+	const int y_start = 400;
+	const int dx = 32;
+	const int dy = 32;
+
+	int index = 0;
+	for (int j = 0; j < N; ++j)
+	{
+		const int x = x_start + j * dx;
+
+		// Bottom particle
+		{
+			Particle particle(Vector2d(x, y_start), Vector2d(0, 0), Vector2d(0, 0), 1.0);
+			particle.fixed = (j == 0);
+			particleSystem.addParticle(particle);
+			if (j > 0)
+			{
+				Spring s(index - 1, index, k, (double)sqrt((double)dx * dx + (double)dy * dy));
+				particleSystem.addSpring(s);
+				Spring s2(index - 2, index, k, (double)dx);
+				particleSystem.addSpring(s2);
+			}
+			++index;
+		}
+
+
+		// Top particle
+		{
+			Particle particle(Vector2d(x, y_start + dy), Vector2d(0, 0), Vector2d(0, 0), 1.0);
+			particle.fixed = (j == 0);
+			particleSystem.addParticle(particle);
+			Spring s(index - 1, index, k, (double)dy);
+			particleSystem.addSpring(s);
+			if (j > 0)
+			{
+				Spring s2(index - 2, index, k, (double)dx);
+				particleSystem.addSpring(s2);
+				Spring s3(index - 3, index, k, (double)sqrt((double)dx * dx + (double)dy * dy));
+				particleSystem.addSpring(s3);
+			}
+			++index;
+		}
+	}
+}
+
+
+/**
+ * Crée un système masse-ressort qui simule un pendule flexible
+ */
+void gti320::createVotreExemple(ParticleSystem& particleSystem, double k)
+{
+	particleSystem.clear();
+
+	// TODO Amusez-vous. Rendu ici, vous le méritez.
+
+
+
+	Particle pillar1(Vector2d(400, 500), Vector2d(0, 0), Vector2d(0, 0), 1.0);
+	pillar1.fixed = true;
+	particleSystem.addParticle(pillar1);
+
+	Particle pillar2(Vector2d(600, 500), Vector2d(0, 0), Vector2d(0, 0), 1.0);
+	pillar2.fixed = true;
+	particleSystem.addParticle(pillar2);
+
+	Particle pillarBase(Vector2d(500, 450), Vector2d(0, 0), Vector2d(0, 0), 1.0);
+	pillar2.fixed = true;
+	particleSystem.addParticle(pillarBase);
+
+	Spring spring1(1, 2, k, std::sqrt(100 * 100 + 50 * 50));
+	particleSystem.addSpring(spring1);
+
+	Spring spring2(0, 2, k, std::sqrt(100 * 100 + 50 * 50));
+	particleSystem.addSpring(spring2);
+
+	Particle cube1(Vector2d(500, 200), Vector2d(50, 0), Vector2d(0, 0), 100.0);
+	particleSystem.addParticle(cube1);
+
+	Particle cube2(Vector2d(500, 150), Vector2d(50, 0), Vector2d(0, 0), 100.0);
+	particleSystem.addParticle(cube2);
+
+	Particle cube3(Vector2d(525, 175), Vector2d(50, 0), Vector2d(0, 0), 100.0);
+	particleSystem.addParticle(cube3);
+
+	Particle cube4(Vector2d(475, 175), Vector2d(50, 0), Vector2d(0, 0), 100.0);
+	particleSystem.addParticle(cube4);
+
+	Particle cube5(Vector2d(500, 175), Vector2d(50, 0), Vector2d(0, 0), 100.0);
+	particleSystem.addParticle(cube5);
+
+	Spring spring3(2, 3, k, 150);
+	particleSystem.addSpring(spring3);
+
+	Spring spring5(3, 5, k, std::sqrt(25 * 25 + 25 * 25));
+	particleSystem.addSpring(spring5);
+
+	Spring spring6(3, 6, k, std::sqrt(25 * 25 + 25 * 25));
+	particleSystem.addSpring(spring6);
+
+	Spring spring7(4, 5, k, std::sqrt(25 * 25 + 25 * 25));
+	particleSystem.addSpring(spring7);
+
+	Spring spring8(4, 6, k, std::sqrt(25 * 25 + 25 * 25));
+	particleSystem.addSpring(spring8);
+
+	Spring spring9(3, 7, k, 25);
+	particleSystem.addSpring(spring9);
+
+	Spring spring10(4, 7, k, 25);
+	particleSystem.addSpring(spring10);
+
+	Spring spring11(5, 7, k, 25);
+	particleSystem.addSpring(spring11);
+
+	Spring spring12(6, 7, k, 25);
+	particleSystem.addSpring(spring12);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+/**
+ * @file Scenes.h
+ *
+ * @brief Modèles masse-ressort prédéfinis, utilisés par l'interface graphique
+ * et par la simulation sans affichage.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include "ParticleSystem.h"
+
+namespace gti320
+{
+	/**
+	 * Crée un système masse-ressort qui simule un tissu suspendu par ses deux
+	 * coins supérieurs. Le tissu compte N x N particules.
+	 */
+	void createHangingCloth(ParticleSystem& particleSystem, double k, int N = 16);
+
+	/**
+	 * Crée un système masse-ressort qui simule une corde suspendu par ses
+	 * extrémités.
+	 */
+	void createHangingRope(ParticleSystem& particleSystem, double k);
+
+	/**
+	 * Crée un système masse-ressort qui simule une poutre flexible
+	 */
+	void createBeam(ParticleSystem& particleSystem, double k);
+
+	/**
+	 * Crée un système masse-ressort qui simule un pendule flexible
+	 */
+	void createVotreExemple(ParticleSystem& particleSystem, double k);
+}
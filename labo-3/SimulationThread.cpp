@@ -0,0 +1,267 @@
+/**
+ * @file SimulationThread.cpp
+ *
+ * @brief Exécution de la simulation dans un fil d'exécution dédié, séparé de
+ * l'affichage.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include "SimulationThread.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace gti320;
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	// Intervalle entre deux résumés des durées des étapes, en secondes
+	static const double PROFILE_INTERVAL = 0.25;
+
+	inline double toSeconds(Clock::time_point time)
+	{
+		return std::chrono::duration<double>(time.time_since_epoch()).count();
+	}
+}
+
+void SimulationSnapshot::interpolatePositions(Vector<double, Dynamic>& outPositions) const
+{
+	if (previousPositions.size() != positions.size() || stepSize <= 0.0)
+	{
+		copyInto(positions, outPositions);
+		return;
+	}
+
+	// alpha vaut 0 à l'instant où l'état précédent devait être remplacé par
+	// l'état actuel, et 1 un pas plus tard, lorsque l'état suivant est dû
+	const double alpha = std::min(std::max((toSeconds(Clock::now()) - stateTime) / stepSize, 0.0), 1.0);
+
+	outPositions.resize(positions.size());
+	for (int i = 0; i < positions.size(); ++i)
+	{
+		outPositions(i) = previousPositions(i) + alpha * (positions(i) - previousPositions(i));
+	}
+}
+
+SimulationThread::SimulationThread(double dt)
+	: m_simulator(), m_dt(dt), m_substeps(1), m_maxSubsteps(5), m_stepCount(0), m_sceneVersion(0), m_stateTime(0.0), m_profile(), m_profileTime(0.0), m_previousPositions(),
+	  m_commands(), m_stepping(false), m_quit(false)
+{
+}
+
+SimulationThread::~SimulationThread()
+{
+	stop();
+}
+
+void SimulationThread::start()
+{
+	if (!m_thread.joinable())
+	{
+		m_quit = false;
+		m_thread = std::thread(&SimulationThread::run, this);
+	}
+}
+
+void SimulationThread::stop()
+{
+	if (m_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_wakeUp.notify_one();
+		m_thread.join();
+	}
+}
+
+void SimulationThread::post(Command command)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_commands.push_back(std::move(command));
+	}
+	m_wakeUp.notify_one();
+}
+
+void SimulationThread::setStepping(bool stepping)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stepping = stepping;
+	}
+	m_wakeUp.notify_one();
+}
+
+void SimulationThread::requestStep()
+{
+	post([this](Simulator&)
+	{
+		for (int i = 0; i < m_substeps; ++i)
+		{
+			step();
+		}
+		// Affiche immédiatement le nouvel état, sans interpolation
+		m_stateTime = toSeconds(Clock::now()) - getStepSize();
+	});
+}
+
+void SimulationThread::setSubsteps(int substeps)
+{
+	post([this, substeps](Simulator&) { m_substeps = std::max(substeps, 1); });
+}
+
+void SimulationThread::setMaxSubsteps(int maxSubsteps)
+{
+	post([this, maxSubsteps](Simulator&) { m_maxSubsteps = std::max(maxSubsteps, 1); });
+}
+
+void SimulationThread::reset()
+{
+	post([this](Simulator& simulator)
+	{
+		simulator.reset();
+		m_stepCount = 0;
+		m_previousPositions.resize(0);
+	});
+}
+
+void SimulationThread::loadScene(eSceneType scene)
+{
+	post([this, scene](Simulator& simulator)
+	{
+		simulator.loadScene(scene);
+		m_stepCount = 0;
+		m_previousPositions.resize(0);
+		++m_sceneVersion;
+	});
+}
+
+void SimulationThread::setMouseSpring(int particle, const Vector2d& target)
+{
+	post([particle, target](Simulator& simulator) { simulator.setMouseSpring(particle, target); });
+}
+
+/**
+ * Boucle du fil de simulation : exécute les commandes reçues puis, si la
+ * simulation est en cours, effectue les pas dus depuis le dernier réveil.
+ *
+ * nextStepTime joue le rôle de l'accumulateur : le temps réel écoulé qui n'a
+ * pas encore été simulé est `now - (nextStepTime - h)`.
+ */
+void SimulationThread::run()
+{
+	auto nextStepTime = Clock::now();
+
+	std::vector<Command> commands;
+	for (;;)
+	{
+		bool stepping;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			const auto hasWork = [this] { return m_quit || !m_commands.empty(); };
+			if (m_stepping)
+			{
+				m_wakeUp.wait_until(lock, nextStepTime, hasWork);
+			}
+			else
+			{
+				m_wakeUp.wait(lock, [this, &hasWork] { return hasWork() || m_stepping; });
+				nextStepTime = Clock::now();
+			}
+
+			if (m_quit)
+			{
+				break;
+			}
+			stepping = m_stepping;
+			commands.swap(m_commands);
+		}
+
+		bool changed = !commands.empty();
+		for (Command& command : commands)
+		{
+			command(m_simulator);
+		}
+		commands.clear();
+
+		const auto now = Clock::now();
+		if (stepping && now >= nextStepTime)
+		{
+			const auto stepDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(getStepSize()));
+
+			int substeps = 0;
+			while (nextStepTime <= now && substeps < m_maxSubsteps)
+			{
+				step();
+				nextStepTime += stepDuration;
+				++substeps;
+			}
+
+			// Retard trop important : il est abandonné plutôt que rattrapé
+			if (nextStepTime <= now)
+			{
+				nextStepTime = now + stepDuration;
+			}
+
+			m_stateTime = toSeconds(nextStepTime) - getStepSize();
+			changed = true;
+		}
+
+		if (changed)
+		{
+			publishSnapshot();
+		}
+	}
+}
+
+void SimulationThread::step()
+{
+	copyInto(m_simulator.getParticleSystem().getPositions(), m_previousPositions);
+	m_simulator.step(getStepSize());
+	++m_stepCount;
+}
+
+void SimulationThread::publishSnapshot()
+{
+	SimulationSnapshot& snapshot = m_snapshots.back();
+	const ParticleSystem& particleSystem = m_simulator.getParticleSystem();
+	const int numParticles = particleSystem.getParticleCount();
+
+	copyInto(particleSystem.getPositions(), snapshot.positions);
+	copyInto(m_previousPositions, snapshot.previousPositions);
+	snapshot.stepSize = getStepSize();
+	snapshot.stateTime = m_stateTime;
+	snapshot.fixed.resize(numParticles);
+	for (int i = 0; i < numParticles; ++i)
+	{
+		snapshot.fixed[i] = particleSystem.isFixed(i);
+	}
+
+	// Les ressorts ne changent qu'au chargement d'un modèle
+	if (snapshot.sceneVersion != m_sceneVersion)
+	{
+		snapshot.springs = particleSystem.getSprings();
+		snapshot.sceneVersion = m_sceneVersion;
+	}
+
+	snapshot.stepCount = m_stepCount;
+	snapshot.solverStats = m_simulator.getSolverStats();
+
+	// Le calcul des centiles n'est fait que quelques fois par seconde
+	const double now = toSeconds(Clock::now());
+	if (now - m_profileTime >= PROFILE_INTERVAL)
+	{
+		m_profile = m_simulator.getProfiler().summarize();
+		m_profileTime = now;
+	}
+	snapshot.profile = m_profile;
+
+	m_snapshots.publish();
+}
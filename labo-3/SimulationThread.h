@@ -0,0 +1,185 @@
+#pragma once
+
+/**
+ * @file SimulationThread.h
+ *
+ * @brief Exécution de la simulation dans un fil d'exécution dédié, séparé de
+ * l'affichage.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include "Simulator.h"
+#include "TripleBuffer.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gti320
+{
+	/**
+	 * État du système publié pour l'affichage après chaque pas
+	 */
+	struct SimulationSnapshot
+	{
+		Vector<double, Dynamic> positions; // positions des particules (x0, y0, x1, y1, ...)
+		Vector<double, Dynamic> previousPositions; // positions avant le dernier pas (vide s'il n'y en a pas)
+		double stepSize = 0.0;             // taille h des pas
+		double stateTime = 0.0;            // instant (horloge monotone, en secondes) où `positions` doit être affiché
+		std::vector<char> fixed;           // particules stationnaires
+		std::vector<Spring> springs;       // les ressorts
+		int sceneVersion = -1;             // modèle dont proviennent les ressorts
+		int stepCount = 0;                 // nombre de pas depuis la dernière réinitialisation
+		SolverStats solverStats;           // statistiques de la dernière résolution
+		StepProfile profile;               // durées des étapes des derniers pas (mis à jour périodiquement)
+
+		int getParticleCount() const { return static_cast<int>(fixed.size()); }
+
+		/**
+		 * Positions à afficher maintenant : interpolation linéaire entre
+		 * `previousPositions` et `positions`. L'affichage a ainsi un pas de
+		 * retard sur la simulation, mais le mouvement reste régulier même
+		 * lorsque les pas ne coïncident pas avec les images.
+		 */
+		void interpolatePositions(Vector<double, Dynamic>& outPositions) const;
+	};
+
+	/**
+	 * Fil d'exécution de la simulation.
+	 *
+	 * Le simulateur appartient au fil de simulation : l'interface ne le
+	 * modifie jamais directement, mais lui envoie des commandes (post) qui sont
+	 * exécutées entre deux pas. Après chaque pas ou commande, l'état du système
+	 * est publié dans un triple tampon que l'affichage consulte sans bloquer
+	 * (updateSnapshot et getSnapshot, à appeler depuis un seul fil).
+	 *
+	 * Lorsque la simulation est en cours, le temps simulé suit le temps réel
+	 * avec un pas fixe : chaque intervalle dt est divisé en `substeps` pas de
+	 * taille h = dt / substeps, effectués dès qu'ils sont dus. Si la
+	 * simulation prend du retard (pas plus longs que h), au plus
+	 * `maxSubsteps` pas sont enchaînés avant que le retard restant soit
+	 * abandonné : la simulation ralentit alors par rapport au temps réel
+	 * plutôt que d'accumuler un retard croissant. L'affichage continue au même
+	 * rythme dans tous les cas.
+	 */
+	class SimulationThread
+	{
+	public:
+		typedef std::function<void(Simulator&)> Command;
+
+		explicit SimulationThread(double dt);
+
+		~SimulationThread();
+
+		SimulationThread(const SimulationThread&) = delete;
+		SimulationThread& operator=(const SimulationThread&) = delete;
+
+		/**
+		 * Démarre le fil de simulation
+		 */
+		void start();
+
+		/**
+		 * Arrête le fil de simulation et attend sa fin
+		 */
+		void stop();
+
+		/**
+		 * Ajoute une commande à exécuter sur le simulateur, dans le fil de
+		 * simulation, avant le prochain pas
+		 */
+		void post(Command command);
+
+		/**
+		 * Démarre ou arrête l'avancement continu de la simulation
+		 */
+		void setStepping(bool stepping);
+
+		/**
+		 * Avance d'un seul intervalle dt (`substeps` pas)
+		 */
+		void requestStep();
+
+		/**
+		 * Nombre de pas par intervalle dt
+		 */
+		void setSubsteps(int substeps);
+
+		/**
+		 * Nombre maximal de pas enchaînés pour rattraper le temps réel
+		 */
+		void setMaxSubsteps(int maxSubsteps);
+
+		/**
+		 * Réinitialise le système et le compteur de pas
+		 */
+		void reset();
+
+		/**
+		 * Charge un modèle prédéfini (voir Simulator::loadScene)
+		 */
+		void loadScene(eSceneType scene);
+
+		/**
+		 * Ressort de la souris (voir Simulator::setMouseSpring)
+		 */
+		void setMouseSpring(int particle, const Vector2d& target);
+
+		/**
+		 * Récupère le dernier état publié. Retourne vrai s'il a changé depuis
+		 * l'appel précédent.
+		 */
+		bool updateSnapshot() { return m_snapshots.update(); }
+
+		/**
+		 * État récupéré par le dernier appel à updateSnapshot
+		 */
+		const SimulationSnapshot& getSnapshot() const { return m_snapshots.front(); }
+
+	private:
+
+		/**
+		 * Boucle du fil de simulation
+		 */
+		void run();
+
+		/**
+		 * Effectue un pas de taille h
+		 */
+		void step();
+
+		double getStepSize() const { return m_dt / m_substeps; }
+
+		/**
+		 * Copie l'état du système dans le tampon arrière et le publie
+		 */
+		void publishSnapshot();
+
+		// État du fil de simulation
+		Simulator m_simulator;
+		const double m_dt;
+		int m_substeps;
+		int m_maxSubsteps;
+		int m_stepCount;
+		int m_sceneVersion;
+		double m_stateTime; // instant où l'état actuel doit être affiché (voir SimulationSnapshot)
+		StepProfile m_profile;      // dernier résumé des durées des étapes
+		double m_profileTime;       // instant du dernier résumé
+		Vector<double, Dynamic> m_previousPositions;
+
+		// Partagé avec l'interface, protégé par m_mutex
+		std::mutex m_mutex;
+		std::condition_variable m_wakeUp;
+		std::vector<Command> m_commands;
+		bool m_stepping;
+		bool m_quit;
+
+		TripleBuffer<SimulationSnapshot> m_snapshots;
+		std::thread m_thread;
+	};
+}
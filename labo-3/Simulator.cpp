@@ -0,0 +1,204 @@
+/**
+ * @file Simulator.cpp
+ *
+ * @brief Simulation d'un système masse-ressort par intégration d'Euler
+ * implicite, indépendante de l'interface graphique.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include "Simulator.h"
+#include "Scenes.h"
+
+using namespace gti320;
+
+Simulator::Simulator()
+	: m_particleSystem(), m_stiffness(300), m_kmax(10), m_solverType(kGaussSeidel), m_preconditionerType(kBlockJacobiPreconditioner),
+	  m_warmStartType(kWarmStartExtrapolated), m_mouseParticle(-1), m_mouseTarget(0, 0)
+{
+}
+
+/**
+ * Effectue un pas de simulation de taille dt.
+ */
+void Simulator::step(double dt)
+{
+	ScopedTimer stepTimer(m_profiler.step());
+
+	// Construction de la matrice de masse
+	//
+	{
+		ScopedTimer timer(m_profiler.phase(kMassPhase));
+		m_particleSystem.buildMassMatrix(m_M);
+	}
+
+	// Calcul des forces actuelles sur chacune des particules et de la matrice
+	// de rigidité, en un seul parcours des ressorts
+	//
+	{
+		ScopedTimer timer(m_profiler.phase(kForcesPhase));
+		m_particleSystem.computeForcesAndJacobian(m_dfdx);
+		applyMouseSpring();
+	}
+
+	// Les vecteurs d'états sont ceux du système de particules : ils sont
+	// utilisés et mis à jour sur place, sans copie.
+	//
+	Vector<double, Dynamic>& x = m_particleSystem.getPositions();
+	Vector<double, Dynamic>& v = m_particleSystem.getVelocities();
+	const Vector<double, Dynamic>& f = m_particleSystem.getForces();
+
+	// La matrice A partage la structure de df/dx puisque la matrice de masse
+	// diagonale ne touche que les blocs diagonaux.
+	{
+		ScopedTimer timer(m_profiler.phase(kAssemblyPhase));
+		m_A = m_M - (dt * dt) * m_dfdx;
+		m_b = dt * f + m_M * v;
+	}
+
+	// Résolution du système d'équations  `A*v_plus = b`.
+	Vector<double, Dynamic>& v_plus = m_vPlus;
+	{
+		ScopedTimer timer(m_profiler.phase(kSolvePhase));
+
+		Vector<double, Dynamic> acc; // vecteur d'accélérations
+		m_solverStats = SolverStats();
+
+		// Estimé initial des solveurs de Jacobi et Gauss-Seidel : la vitesse
+		// actuelle (solution du pas précédent) ou son extrapolation à partir des
+		// deux derniers pas, 2 v(t) - v(t - dt).
+		const bool warmStart = m_warmStartType != kNoWarmStart;
+		if (warmStart)
+		{
+			copyInto(v, v_plus);
+			if (m_warmStartType == kWarmStartExtrapolated && m_vPrevious.size() == v.size())
+			{
+				for (int i = 0; i < v_plus.size(); ++i)
+					v_plus(i) = 2.0 * v(i) - m_vPrevious(i);
+			}
+		}
+		copyInto(v, m_vPrevious);
+		switch (m_solverType)
+		{
+		case kGaussSeidel:
+			gaussSeidel(m_A, m_b, v_plus, m_kmax, m_solverWorkspace, &m_solverStats, warmStart);
+			break;
+		case kColoredGaussSeidel:
+			// La coloration des particules suit la structure de df/dx, et donc de A
+			gaussSeidel(m_A, m_b, v_plus, m_kmax, m_particleSystem.getColorPointers(), m_particleSystem.getColorParticles(), m_solverWorkspace, &m_solverStats, warmStart);
+			break;
+		case kCholesky:
+			if (!cholesky(m_A, m_b, v_plus, m_cholesky, &m_solverStats))
+			{
+				// A n'est pas définie positive (ressorts très comprimés) : on se
+				// rabat sur un solveur itératif
+				preconditionedConjugateGradient(m_A, m_b, v_plus, m_kmax, m_preconditionerType, m_solverWorkspace, &m_solverStats);
+			}
+			break;
+		case kConjugateGradient:
+			conjugateGradient(m_A, m_b, v_plus, m_kmax, m_solverWorkspace, &m_solverStats);
+			break;
+		case kPCG:
+			preconditionedConjugateGradient(m_A, m_b, v_plus, m_kmax, m_preconditionerType, m_solverWorkspace, &m_solverStats);
+			break;
+		default:
+			jacobi(m_A, m_b, v_plus, m_kmax, m_solverWorkspace, &m_solverStats, warmStart);
+			break;
+		case kNone:
+			// N'utilise pas de solveur, il s'agit de l'implémentation naive de
+			// l'intégration d'Euler.
+			acc.resize(m_M.rows()); // vecteur d'accélérations
+			for (int i = 0; i < m_M.rows(); ++i)
+				acc(i) = (1.0 / m_M(i)) * f(i);
+			v_plus = v + dt * acc;
+			break;
+		}
+	}
+
+	// Mise à jour du vecteur d'état de position via l'intégration d'Euler
+	// implicite. Les nouvelles position sont calculées à partir des position
+	// actuelles x et des nouvelles vitesses v_plus. Les nouvelles positions
+	// sont stockées directement dans le vecteur x, donc dans les particules.
+	// Les anciennes vitesses restent dans v_plus, dont la mémoire est
+	// réutilisée au pas suivant.
+	{
+		ScopedTimer timer(m_profiler.phase(kIntegrationPhase));
+		x = x + dt * v_plus;
+		v.swap(v_plus);
+	}
+}
+
+/**
+ * Réinitialisation du système de particules
+ */
+void Simulator::reset()
+{
+	copyInto(m_p0, m_particleSystem.getPositions());
+	copyInto(m_v0, m_particleSystem.getVelocities());
+	m_vPrevious.resize(0);
+
+	setStiffness(m_stiffness);
+}
+
+/**
+ * Conserve les positions et les vitesses du modèle chargé pour les
+ * réinitialisations
+ */
+void Simulator::saveInitialState()
+{
+	copyInto(m_particleSystem.getPositions(), m_p0);
+	copyInto(m_particleSystem.getVelocities(), m_v0);
+}
+
+void Simulator::loadScene(eSceneType scene, int size)
+{
+	m_mouseParticle = -1;
+	m_profiler.clear();
+
+	switch (scene)
+	{
+	case kHangingCloth:
+		createHangingCloth(m_particleSystem, m_stiffness, size);
+		break;
+	case kHangingRope:
+		createHangingRope(m_particleSystem, m_stiffness);
+		break;
+	case kVotreExemple:
+		createVotreExemple(m_particleSystem, m_stiffness);
+		break;
+	default:
+		createBeam(m_particleSystem, m_stiffness);
+		break;
+	}
+
+	saveInitialState();
+	reset();
+}
+
+void Simulator::setMouseSpring(int particle, const Vector2d& target)
+{
+	m_mouseParticle = particle < m_particleSystem.getParticleCount() ? particle : -1;
+	m_mouseTarget = target;
+}
+
+void Simulator::setStiffness(double k)
+{
+	m_stiffness = k;
+	for (Spring& s : m_particleSystem.getSprings())
+	{
+		s.k = k;
+	}
+}
+
+void Simulator::applyMouseSpring()
+{
+	if (m_mouseParticle >= 0)
+	{
+		ParticleRef particle = m_particleSystem.getParticle(m_mouseParticle);
+		const double k = 20.0 * particle.m();
+		const Vector2d f = k * (m_mouseTarget - particle.x());
+		particle.addForce(f);
+	}
+}
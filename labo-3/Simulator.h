@@ -0,0 +1,132 @@
+#pragma once
+
+/**
+ * @file Simulator.h
+ *
+ * @brief Simulation d'un système masse-ressort par intégration d'Euler
+ * implicite, indépendante de l'interface graphique.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include "ParticleSystem.h"
+#include "Profiler.h"
+#include "Solvers.hpp"
+
+namespace gti320
+{
+	// Modèles prédéfinis (voir Scenes.h)
+	enum eSceneType { kHangingCloth, kBeam, kHangingRope, kVotreExemple };
+
+	/**
+	 * Simulateur : le système de particules, son état initial, les matrices du
+	 * système linéaire et les paramètres des solveurs.
+	 *
+	 * Chaque pas construit la matrice de masse, les forces et df/dx, assemble
+	 * le système `(M - dt^2 df/dx) v_plus = dt f + M v`, le résout avec le
+	 * solveur choisi puis intègre les positions.
+	 */
+	class Simulator
+	{
+	public:
+		Simulator();
+
+		/**
+		 * Effectue un pas de simulation d'un intervalle de temps dt
+		 */
+		void step(double dt);
+
+		/**
+		 * Remet le système dans l'état conservé par saveInitialState
+		 */
+		void reset();
+
+		/**
+		 * Conserve les positions et les vitesses actuelles comme état initial
+		 */
+		void saveInitialState();
+
+		/**
+		 * Charge un modèle prédéfini avec la rigidité actuelle, puis le
+		 * réinitialise. `size` est le nombre de particules par côté du tissu.
+		 */
+		void loadScene(eSceneType scene, int size = 16);
+
+		/**
+		 * Ressort entre la particule `particle` et le point `target` (la souris),
+		 * appliqué à chaque pas. Une particule négative retire le ressort.
+		 */
+		void setMouseSpring(int particle, const Vector2d& target);
+
+		/**
+		 * Affecte la rigidité `k` à tous les ressorts
+		 */
+		void setStiffness(double k);
+		double getStiffness() const { return m_stiffness; }
+
+		void setSolverType(eSolverType solverType) { m_solverType = solverType; }
+		eSolverType getSolverType() const { return m_solverType; }
+
+		void setPreconditionerType(ePreconditionerType preconditionerType) { m_preconditionerType = preconditionerType; }
+		ePreconditionerType getPreconditionerType() const { return m_preconditionerType; }
+
+		void setWarmStartType(eWarmStartType warmStartType) { m_warmStartType = warmStartType; }
+		eWarmStartType getWarmStartType() const { return m_warmStartType; }
+
+		void setMaxIterations(int kmax) { m_kmax = kmax; }
+		int getMaxIterations() const { return m_kmax; }
+
+		const ParticleSystem& getParticleSystem() const { return m_particleSystem; }
+		ParticleSystem& getParticleSystem() { return m_particleSystem; }
+
+		const DiagonalMatrix<double>& getMassMatrix() const { return m_M; }
+		const BlockSparseMatrix<double>& getStiffnessMatrix() const { return m_dfdx; }
+		const BlockSparseMatrix<double>& getSystemMatrix() const { return m_A; }
+
+		// Statistiques de la dernière résolution (vides sans solveur)
+		const SolverStats& getSolverStats() const { return m_solverStats; }
+
+		// Durées des étapes des derniers pas (voir Profiler.h)
+		const StepProfiler& getProfiler() const { return m_profiler; }
+		StepProfiler& getProfiler() { return m_profiler; }
+
+	private:
+
+		/**
+		 * Ajoute la force du ressort de la souris, s'il y en a un
+		 */
+		void applyMouseSpring();
+
+		ParticleSystem m_particleSystem;
+
+		double m_stiffness;                      // la rigidité des ressorts
+		int m_kmax;                              // nombre max d'itération pour les solveurs itératifs
+		eSolverType m_solverType;                // indique le choix du solveur
+		ePreconditionerType m_preconditionerType; // préconditionneur utilisé par le gradient conjugué préconditionné
+		eWarmStartType m_warmStartType;          // estimé initial des solveurs de Jacobi et Gauss-Seidel
+		SolverWorkspace m_solverWorkspace;       // espace de travail réutilisé par les solveurs itératifs
+		SolverStats m_solverStats;               // statistiques de la dernière résolution
+		StepProfiler m_profiler;                 // durées des étapes des derniers pas
+
+		// Ressort de la souris
+		int m_mouseParticle;    // indice de la particule attachée, -1 si aucune
+		Vector2d m_mouseTarget; // position de la souris
+
+		// Matrices du système
+		DiagonalMatrix<double> m_M;         // matrice de masses
+		BlockSparseMatrix<double> m_dfdx;   // matrice de rigidité
+		BlockSparseMatrix<double> m_A;      // matrice du système M - dt^2 * df/dx
+		CachedCholesky m_cholesky;          // factorisation de Cholesky creuse de A, réutilisée d'un pas à l'autre
+
+		// Les vecteurs d'état sont stockés dans le système de particules
+		Vector<double, Dynamic> m_b;        // membre de droite dt * f + M * v
+		Vector<double, Dynamic> m_vPlus;    // vélocités à la fin du pas
+		Vector<double, Dynamic> m_vPrevious; // vélocités du pas précédent (estimé initial extrapolé)
+
+		// État initial (utilisé pour réinitialiser le système)
+		Vector<double, Dynamic> m_p0; // positions des particules
+		Vector<double, Dynamic> m_v0; // vélocités des particules
+	};
+}
@@ -14,103 +14,745 @@
 #include <omp.h>
 
 #include "Math3D.h"
+#include "SparseCholesky.hpp"
+#include <limits>
 #include <stdio.h>
+#include <utility>
+#include <vector>
 
 namespace gti320
 {
 	// Identification des solveurs
-	enum eSolverType { kNone, kJacobi, kGaussSeidel, kCholesky };
+	enum eSolverType { kNone, kJacobi, kGaussSeidel, kCholesky, kConjugateGradient, kPCG, kColoredGaussSeidel };
+
+	// Identification des préconditionneurs pour le gradient conjugué
+	enum ePreconditionerType { kJacobiPreconditioner, kBlockJacobiPreconditioner };
+
+	// Choix de l'estimé initial des solveurs de Jacobi et Gauss-Seidel
+	enum eWarmStartType { kNoWarmStart, kWarmStartPrevious, kWarmStartExtrapolated };
 
 	// Paramètres de convergences pour les algorithmes itératifs
 	static const double epsilon = 1e-4;
 	static const double tau = 1e-5;
 
+	/**
+	 * Statistiques d'une résolution.
+	 *
+	 * Pour Cholesky, `iterations` est le nombre d'itérations de raffinement
+	 * appliquées à la solution obtenue avec un facteur réutilisé. Une durée
+	 * nulle indique qu'aucun solveur n'a été utilisé.
+	 */
+	struct SolverStats
+	{
+		int iterations; // nombre d'itérations dont le résultat a été conservé
+		double residual; // résidu relatif final ||b - Ax|| / ||b||
+		double time; // durée de la résolution (secondes)
+		bool refactored; // Cholesky : vrai lorsque A a été factorisée à nouveau
+
+		SolverStats() : iterations(0), residual(0.0), time(0.0), refactored(false)
+		{
+		}
+	};
+
+	/**
+	 * Extrait le bloc diagonal 2x2 d'indice `blockRow` d'une matrice dense
+	 * (stocké par lignes).
+	 */
+	inline void extractDiagonalBlock(const Matrix<double, Dynamic, Dynamic>& A, int blockRow, double outBlock[4])
+	{
+		const auto i = 2 * blockRow;
+
+		outBlock[0] = A(i, i);
+		outBlock[1] = A(i, i + 1);
+		outBlock[2] = A(i + 1, i);
+		outBlock[3] = A(i + 1, i + 1);
+	}
+
+	/**
+	 * Extrait le bloc diagonal 2x2 d'indice `blockRow` d'une matrice creuse par
+	 * blocs (stocké par lignes).
+	 */
+	inline void extractDiagonalBlock(const BlockSparseMatrix<double>& A, int blockRow, double outBlock[4])
+	{
+		const double* block = A.block(A.diagonalBlock(blockRow));
+
+		for (auto j = 0; j < 4; ++j)
+		{
+			outBlock[j] = block[j];
+		}
+	}
+
+	/**
+	 * Préconditionneur de Jacobi par blocs 2x2.
+	 *
+	 * Le préconditionneur approxime l'inverse de A par l'inverse de ses blocs
+	 * diagonaux 2x2, soit les deux degrés de liberté d'une même particule. Le
+	 * préconditionneur de Jacobi (diagonal) correspond au cas où les termes hors
+	 * diagonale de ces blocs sont ignorés.
+	 */
+	class BlockJacobiPreconditioner
+	{
+	private:
+		std::vector<double> m_inverseBlocks; // Inverse des blocs diagonaux (stockés par lignes)
+
+	public:
+		/**
+		 * Calcule l'inverse des blocs diagonaux de A
+		 */
+		template <typename MatrixType>
+		void compute(const MatrixType& A, ePreconditionerType type)
+		{
+			ASSERT(A.rows() == A.cols(), "Trying to build a preconditioner with a non square matrix");
+			ASSERT(A.rows() % 2 == 0, "Trying to build a 2x2 block preconditioner with a matrix of odd size");
+
+			const auto blockRows = A.rows() / 2;
+			m_inverseBlocks.resize(4 * blockRows);
+
+			for (auto blockRow = 0; blockRow < blockRows; ++blockRow)
+			{
+				double block[4];
+				extractDiagonalBlock(A, blockRow, block);
+
+				double* inverse = m_inverseBlocks.data() + 4 * blockRow;
+				if (type == kJacobiPreconditioner)
+				{
+					inverse[0] = 1.0 / block[0];
+					inverse[1] = 0.0;
+					inverse[2] = 0.0;
+					inverse[3] = 1.0 / block[3];
+				}
+				else
+				{
+					// Pour le bloc [a b; c d], det = a d (1 - (b / a) (c / d)) :
+					// le produit a d n'est jamais formé puisqu'il déborde pour
+					// les particules fixes, dont la masse est immense.
+					const auto ratio01 = block[1] / block[0];
+					const auto ratio23 = block[2] / block[3];
+					const auto inverseFactor = 1.0 / (1.0 - ratio01 * ratio23);
+					inverse[0] = inverseFactor / block[0];
+					inverse[1] = -ratio01 * inverseFactor / block[3];
+					inverse[2] = -ratio23 * inverseFactor / block[0];
+					inverse[3] = inverseFactor / block[3];
+				}
+			}
+		}
+
+		/**
+		 * Applique le préconditionneur : z = P^-1 r
+		 */
+		void apply(const Vector<double, Dynamic>& r, Vector<double, Dynamic>& outZ) const
+		{
+			const auto blockRows = static_cast<int>(m_inverseBlocks.size() / 4);
+			ASSERT(r.size() == 2 * blockRows, "Trying to apply a preconditioner to a vector of incompatible size");
+
+			outZ.resize(r.size());
+
+			#pragma omp parallel for
+			for (auto blockRow = 0; blockRow < blockRows; ++blockRow)
+			{
+				const double* inverse = m_inverseBlocks.data() + 4 * blockRow;
+				const auto first = r(2 * blockRow);
+				const auto second = r(2 * blockRow + 1);
+
+				outZ(2 * blockRow) = inverse[0] * first + inverse[1] * second;
+				outZ(2 * blockRow + 1) = inverse[2] * first + inverse[3] * second;
+			}
+		}
+	};
+
+	/**
+	 * Espace de travail des solveurs itératifs.
+	 *
+	 * Les vecteurs sont conservés d'une résolution à l'autre et ne sont
+	 * réalloués que lorsque la taille du système change.
+	 */
+	struct SolverWorkspace
+	{
+		Vector<double, Dynamic> nextSolution; // itéré suivant (Jacobi)
+		Vector<double, Dynamic> lastSolution; // itéré précédent (Gauss-Seidel)
+
+		// Gradient conjugué, avec ou sans préconditionneur
+		Vector<double, Dynamic> residual; // r
+		Vector<double, Dynamic> preconditionedResidual; // z = P^-1 r
+		Vector<double, Dynamic> direction; // p
+		Vector<double, Dynamic> Ap; // A p
+		std::vector<char> dirichlet; // lignes de Dirichlet (gradient conjugué sans préconditionneur)
+		BlockJacobiPreconditioner preconditioner;
+
+		void resize(int size)
+		{
+			if (nextSolution.size() != size) nextSolution.resize(size);
+			if (lastSolution.size() != size) lastSolution.resize(size);
+		}
+
+		/**
+		 * Dimensionne les vecteurs du gradient conjugué, qui ne sont pas
+		 * utilisés par Jacobi et Gauss-Seidel.
+		 */
+		void resizeConjugateGradient(int size)
+		{
+			if (residual.size() != size) residual.resize(size);
+			if (preconditionedResidual.size() != size) preconditionedResidual.resize(size);
+			if (direction.size() != size) direction.resize(size);
+			if (Ap.size() != size) Ap.resize(size);
+			dirichlet.resize(size);
+		}
+	};
+
+	/**
+	 * Copie `source` dans `destination` sans réallouer lorsque les tailles sont
+	 * identiques.
+	 */
+	inline void copyInto(const Vector<double, Dynamic>& source, Vector<double, Dynamic>& destination)
+	{
+		if (destination.size() != source.size())
+		{
+			destination.resize(source.size());
+		}
+
+		for (auto i = 0; i < source.size(); ++i)
+		{
+			destination(i) = source(i);
+		}
+	}
+
+	/**
+	 * Calcule le résidu relatif ||b - Ax|| / ||b|| sans allocation.
+	 */
+	inline double relativeResidual(const Matrix<double, Dynamic, Dynamic>& A,
+	                               const Vector<double, Dynamic>& b,
+	                               const Vector<double, Dynamic>& x)
+	{
+		auto squaredResidual = 0.0;
+
+		#pragma omp parallel for reduction(+ : squaredResidual)
+		for (auto i = 0; i < A.rows(); ++i)
+		{
+			auto residualElement = b(i);
+			for (auto j = 0; j < A.cols(); ++j)
+			{
+				residualElement -= A(i, j) * x(j);
+			}
+			squaredResidual += residualElement * residualElement;
+		}
+
+		return sqrt(squaredResidual) / b.norm();
+	}
+
+	inline double relativeResidual(const BlockSparseMatrix<double>& A,
+	                               const Vector<double, Dynamic>& b,
+	                               const Vector<double, Dynamic>& x)
+	{
+		auto squaredResidual = 0.0;
+
+		#pragma omp parallel for reduction(+ : squaredResidual)
+		for (auto blockRow = 0; blockRow < A.blockRows(); ++blockRow)
+		{
+			auto r0 = b(2 * blockRow);
+			auto r1 = b(2 * blockRow + 1);
+			for (auto k = A.blockRowBegin(blockRow); k < A.blockRowEnd(blockRow); ++k)
+			{
+				const double* values = A.block(k);
+				const auto j = 2 * A.blockCol(k);
+				r0 -= values[0] * x(j) + values[1] * x(j + 1);
+				r1 -= values[2] * x(j) + values[3] * x(j + 1);
+			}
+			squaredResidual += r0 * r0 + r1 * r1;
+		}
+
+		return sqrt(squaredResidual) / b.norm();
+	}
+
+	/*
+	 * Remarques sur les solveurs de Jacobi et Gauss-Seidel
+	 *
+	 * Les critères d'arrêt sont ceux de la version d'origine : on s'arrête après
+	 * k_max itérations, lorsque ||x_k - x_k-1|| / ||x_k|| <= tau ou lorsque
+	 * ||b - A x_k|| / ||b|| <= epsilon.
+	 *
+	 * Le résidu de x_k n'est toutefois pas calculé par un produit matrice-vecteur
+	 * supplémentaire : il est accumulé pendant le balayage suivant, qui parcourt
+	 * de toute façon les lignes de A avec les valeurs de x_k. Si ce résidu
+	 * indique que x_k avait convergé, le résultat du balayage est abandonné et
+	 * x_k est retourné. Le résultat est donc identique, au prix d'un balayage
+	 * de plus à la toute fin.
+	 *
+	 * L'estimé initial est b, sauf lorsque `warmStart` est vrai : la valeur de
+	 * `outSolution` à l'appel (par exemple la solution du pas précédent) est
+	 * alors utilisée.
+	 */
+
 	/**
 	 * Résout Ax = b avec la méthode de Jacobi
 	 */
-	static void jacobi(const Matrix<double, Dynamic, Dynamic>& A,
+	inline void jacobi(const Matrix<double, Dynamic, Dynamic>& A,
 	                   const Vector<double, Dynamic>& b,
-	                   Vector<double, Dynamic>& outSolution, int k_max)
+	                   Vector<double, Dynamic>& outSolution, int k_max,
+	                   SolverWorkspace& workspace, SolverStats* outStats = nullptr,
+	                   bool warmStart = false)
 	{
 		ASSERT(A.rows() == A.cols(), "Trying to apply Jacobi solver with a non square matrix");
 		ASSERT(b.size() == A.rows(), "Trying to apply Jacobi solver with a vector of size incompatible with the matrix");
 
-		outSolution = b;
+		const auto startTime = omp_get_wtime();
+		const auto size = A.rows();
+		const auto bNorm = b.norm();
 
-		// z: partialSolution
-		auto partialSolution = b;
+		workspace.resize(size);
+		if (!warmStart || outSolution.size() != b.size())
+		{
+			copyInto(b, outSolution);
+		}
 
-		auto size = A.rows();
+		// Les deux vecteurs échangent leur rôle à chaque itération
+		Vector<double, Dynamic>* solution = &outSolution;
+		Vector<double, Dynamic>* partialSolution = &workspace.nextSolution;
 
 		auto numberOfIterations = 0;
-		Vector<double, Dynamic> lastSolution;
-		do
+		auto residual = -1.0;
+		auto checkResidual = false;
+		while (true)
 		{
-			lastSolution = outSolution;
+			const auto& x = *solution;
+			auto& z = *partialSolution;
 
-			#pragma omp parallel for
+			auto squaredResidual = 0.0;
+			auto squaredStep = 0.0;
+			auto squaredNorm = 0.0;
+
+			#pragma omp parallel for reduction(+ : squaredResidual, squaredStep, squaredNorm)
 			for (auto i = 0; i < size; ++i)
 			{
 				auto partialSolutionElement = b(i);
 
 				for (auto j = 0; j < i; ++j)
 				{
-					partialSolutionElement -= A(i, j) * outSolution(j);
+					partialSolutionElement -= A(i, j) * x(j);
 				}
 				for (auto j = i + 1; j < size; ++j)
 				{
-					partialSolutionElement -= A(i, j) * outSolution(j);
+					partialSolutionElement -= A(i, j) * x(j);
 				}
 
+				const auto residualElement = partialSolutionElement - A(i, i) * x(i);
 				partialSolutionElement /= A(i, i);
-				partialSolution(i) = partialSolutionElement;
+				z(i) = partialSolutionElement;
+
+				squaredResidual += residualElement * residualElement;
+				squaredStep += (partialSolutionElement - x(i)) * (partialSolutionElement - x(i));
+				squaredNorm += partialSolutionElement * partialSolutionElement;
+			}
+
+			// Le résidu calculé est celui de l'itéré précédent
+			if (checkResidual && !(sqrt(squaredResidual) / bNorm > epsilon))
+			{
+				residual = sqrt(squaredResidual) / bNorm;
+				break;
 			}
 
-			outSolution = partialSolution;
+			std::swap(solution, partialSolution);
 			++numberOfIterations;
 
-		} while (numberOfIterations < k_max && (outSolution - lastSolution).norm() / outSolution.norm() > tau && (A * outSolution - b).norm() / b.norm() > epsilon);
+			if (!(numberOfIterations < k_max && sqrt(squaredStep) / sqrt(squaredNorm) > tau))
+			{
+				break;
+			}
+			checkResidual = true;
+		}
+
+		if (solution != &outSolution)
+		{
+			copyInto(*solution, outSolution);
+		}
+
+		if (outStats != nullptr)
+		{
+			outStats->iterations = numberOfIterations;
+			outStats->residual = residual >= 0.0 ? residual : relativeResidual(A, b, outSolution);
+			outStats->time = omp_get_wtime() - startTime;
+		}
 	}
 
 
 	/**
 	 * Résout Ax = b avec la méthode Gauss-Seidel
 	 */
-	static void gaussSeidel(const Matrix<double, Dynamic, Dynamic>& A,
+	inline void gaussSeidel(const Matrix<double, Dynamic, Dynamic>& A,
 	                        const Vector<double, Dynamic>& b,
-	                        Vector<double, Dynamic>& outSolution, int k_max)
+	                        Vector<double, Dynamic>& outSolution, int k_max,
+	                        SolverWorkspace& workspace, SolverStats* outStats = nullptr,
+	                        bool warmStart = false)
 	{
 		ASSERT(A.rows() == A.cols(), "Trying to apply Gauss-Seidel solver with a non square matrix");
 		ASSERT(b.size() == A.rows(), "Trying to apply Gauss-Seidel solver with a vector of size incompatible with the matrix");
 
-		outSolution = b;
+		const auto startTime = omp_get_wtime();
+		const auto size = A.rows();
+		const auto bNorm = b.norm();
+
+		workspace.resize(size);
+		if (!warmStart || outSolution.size() != b.size())
+		{
+			copyInto(b, outSolution);
+		}
+
+		auto& lastSolution = workspace.lastSolution;
 
-		auto size = A.rows();
 		auto numberOfIterations = 0;
-		Vector<double, Dynamic> lastSolution;
-		do
+		auto residual = -1.0;
+		auto checkResidual = false;
+		while (true)
 		{
-			lastSolution = outSolution;
+			copyInto(outSolution, lastSolution);
+
+			auto squaredResidual = 0.0;
+			auto squaredStep = 0.0;
+			auto squaredNorm = 0.0;
 
 			for (auto i = 0; i < size; ++i)
 			{
-				outSolution(i) = b(i);
+				auto solutionElement = b(i);
+				auto residualElement = b(i) - A(i, i) * lastSolution(i);
 
 				for (auto j = 0; j < i; ++j)
 				{
-					outSolution(i) -= A(i, j) * outSolution(j);
+					solutionElement -= A(i, j) * outSolution(j);
+					residualElement -= A(i, j) * lastSolution(j);
 				}
 				for (auto j = i + 1; j < size; ++j)
 				{
-					outSolution(i) -= A(i, j) * outSolution(j);
+					// Les éléments suivants n'ont pas encore été mis à jour
+					const auto product = A(i, j) * outSolution(j);
+					solutionElement -= product;
+					residualElement -= product;
+				}
+
+				outSolution(i) = solutionElement / A(i, i);
+
+				squaredResidual += residualElement * residualElement;
+				squaredStep += (outSolution(i) - lastSolution(i)) * (outSolution(i) - lastSolution(i));
+				squaredNorm += outSolution(i) * outSolution(i);
+			}
+
+			// Le résidu calculé est celui de l'itéré précédent
+			if (checkResidual && !(sqrt(squaredResidual) / bNorm > epsilon))
+			{
+				residual = sqrt(squaredResidual) / bNorm;
+				copyInto(lastSolution, outSolution);
+				break;
+			}
+
+			++numberOfIterations;
+
+			if (!(numberOfIterations < k_max && sqrt(squaredStep) / sqrt(squaredNorm) > tau))
+			{
+				break;
+			}
+			checkResidual = true;
+		}
+
+		if (outStats != nullptr)
+		{
+			outStats->iterations = numberOfIterations;
+			outStats->residual = residual >= 0.0 ? residual : relativeResidual(A, b, outSolution);
+			outStats->time = omp_get_wtime() - startTime;
+		}
+	}
+
+	/**
+	 * Résout Ax = b avec la méthode de Jacobi pour une matrice creuse par blocs
+	 */
+	inline void jacobi(const BlockSparseMatrix<double>& A,
+	                   const Vector<double, Dynamic>& b,
+	                   Vector<double, Dynamic>& outSolution, int k_max,
+	                   SolverWorkspace& workspace, SolverStats* outStats = nullptr,
+	                   bool warmStart = false)
+	{
+		ASSERT(b.size() == A.rows(), "Trying to apply Jacobi solver with a vector of size incompatible with the matrix");
+
+		const auto startTime = omp_get_wtime();
+		const auto size = A.rows();
+		const auto bNorm = b.norm();
+
+		workspace.resize(size);
+		if (!warmStart || outSolution.size() != b.size())
+		{
+			copyInto(b, outSolution);
+		}
+
+		// Les deux vecteurs échangent leur rôle à chaque itération
+		Vector<double, Dynamic>* solution = &outSolution;
+		Vector<double, Dynamic>* partialSolution = &workspace.nextSolution;
+
+		auto numberOfIterations = 0;
+		auto residual = -1.0;
+		auto checkResidual = false;
+		while (true)
+		{
+			const auto& x = *solution;
+			auto& z = *partialSolution;
+
+			auto squaredResidual = 0.0;
+			auto squaredStep = 0.0;
+			auto squaredNorm = 0.0;
+
+			#pragma omp parallel for reduction(+ : squaredResidual, squaredStep, squaredNorm)
+			for (auto i = 0; i < size; ++i)
+			{
+				const auto blockRow = i / 2;
+				const auto rowInBlock = i % 2;
+
+				auto partialSolutionElement = b(i);
+				auto diagonalElement = 1.0;
+
+				for (auto k = A.blockRowBegin(blockRow); k < A.blockRowEnd(blockRow); ++k)
+				{
+					const double* values = A.block(k) + 2 * rowInBlock;
+					const auto j = 2 * A.blockCol(k);
+
+					for (auto c = 0; c < 2; ++c)
+					{
+						if (j + c == i)
+						{
+							diagonalElement = values[c];
+						}
+						else
+						{
+							partialSolutionElement -= values[c] * x(j + c);
+						}
+					}
+				}
+
+				const auto residualElement = partialSolutionElement - diagonalElement * x(i);
+				partialSolutionElement /= diagonalElement;
+				z(i) = partialSolutionElement;
+
+				squaredResidual += residualElement * residualElement;
+				squaredStep += (partialSolutionElement - x(i)) * (partialSolutionElement - x(i));
+				squaredNorm += partialSolutionElement * partialSolutionElement;
+			}
+
+			// Le résidu calculé est celui de l'itéré précédent
+			if (checkResidual && !(sqrt(squaredResidual) / bNorm > epsilon))
+			{
+				residual = sqrt(squaredResidual) / bNorm;
+				break;
+			}
+
+			std::swap(solution, partialSolution);
+			++numberOfIterations;
+
+			if (!(numberOfIterations < k_max && sqrt(squaredStep) / sqrt(squaredNorm) > tau))
+			{
+				break;
+			}
+			checkResidual = true;
+		}
+
+		if (solution != &outSolution)
+		{
+			copyInto(*solution, outSolution);
+		}
+
+		if (outStats != nullptr)
+		{
+			outStats->iterations = numberOfIterations;
+			outStats->residual = residual >= 0.0 ? residual : relativeResidual(A, b, outSolution);
+			outStats->time = omp_get_wtime() - startTime;
+		}
+	}
+
+	/**
+	 * Relaxe les deux lignes de la ligne de blocs `blockRow` (Gauss-Seidel).
+	 *
+	 * Les contributions de la ligne de blocs au résidu de l'itéré précédent
+	 * `lastSolution` et à la variation de la solution sont ajoutées à
+	 * `squaredResidual` et `squaredStep`, et celles à la norme de la nouvelle
+	 * solution à `squaredNorm`.
+	 */
+	inline void relaxBlockRow(const BlockSparseMatrix<double>& A,
+	                                 const Vector<double, Dynamic>& b,
+	                                 const Vector<double, Dynamic>& lastSolution,
+	                                 Vector<double, Dynamic>& outSolution, int blockRow,
+	                                 double& squaredResidual, double& squaredStep, double& squaredNorm)
+	{
+		for (auto rowInBlock = 0; rowInBlock < 2; ++rowInBlock)
+		{
+			const auto i = 2 * blockRow + rowInBlock;
+
+			auto solutionElement = b(i);
+			auto residualElement = b(i);
+			auto diagonalElement = 1.0;
+
+			for (auto k = A.blockRowBegin(blockRow); k < A.blockRowEnd(blockRow); ++k)
+			{
+				const double* values = A.block(k) + 2 * rowInBlock;
+				const auto j = 2 * A.blockCol(k);
+
+				for (auto c = 0; c < 2; ++c)
+				{
+					residualElement -= values[c] * lastSolution(j + c);
+
+					if (j + c == i)
+					{
+						diagonalElement = values[c];
+					}
+					else
+					{
+						solutionElement -= values[c] * outSolution(j + c);
+					}
+				}
+			}
+
+			outSolution(i) = solutionElement / diagonalElement;
+
+			squaredResidual += residualElement * residualElement;
+			squaredStep += (outSolution(i) - lastSolution(i)) * (outSolution(i) - lastSolution(i));
+			squaredNorm += outSolution(i) * outSolution(i);
+		}
+	}
+
+	/**
+	 * Résout Ax = b avec la méthode Gauss-Seidel pour une matrice creuse par blocs
+	 */
+	inline void gaussSeidel(const BlockSparseMatrix<double>& A,
+	                        const Vector<double, Dynamic>& b,
+	                        Vector<double, Dynamic>& outSolution, int k_max,
+	                        SolverWorkspace& workspace, SolverStats* outStats = nullptr,
+	                        bool warmStart = false)
+	{
+		ASSERT(b.size() == A.rows(), "Trying to apply Gauss-Seidel solver with a vector of size incompatible with the matrix");
+
+		const auto startTime = omp_get_wtime();
+		const auto bNorm = b.norm();
+
+		workspace.resize(A.rows());
+		if (!warmStart || outSolution.size() != b.size())
+		{
+			copyInto(b, outSolution);
+		}
+
+		auto& lastSolution = workspace.lastSolution;
+
+		auto numberOfIterations = 0;
+		auto residual = -1.0;
+		auto checkResidual = false;
+		while (true)
+		{
+			copyInto(outSolution, lastSolution);
+
+			auto squaredResidual = 0.0;
+			auto squaredStep = 0.0;
+			auto squaredNorm = 0.0;
+
+			for (auto blockRow = 0; blockRow < A.blockRows(); ++blockRow)
+			{
+				relaxBlockRow(A, b, lastSolution, outSolution, blockRow, squaredResidual, squaredStep, squaredNorm);
+			}
+
+			// Le résidu calculé est celui de l'itéré précédent
+			if (checkResidual && !(sqrt(squaredResidual) / bNorm > epsilon))
+			{
+				residual = sqrt(squaredResidual) / bNorm;
+				copyInto(lastSolution, outSolution);
+				break;
+			}
+
+			++numberOfIterations;
+
+			if (!(numberOfIterations < k_max && sqrt(squaredStep) / sqrt(squaredNorm) > tau))
+			{
+				break;
+			}
+			checkResidual = true;
+		}
+
+		if (outStats != nullptr)
+		{
+			outStats->iterations = numberOfIterations;
+			outStats->residual = residual >= 0.0 ? residual : relativeResidual(A, b, outSolution);
+			outStats->time = omp_get_wtime() - startTime;
+		}
+	}
+
+	/**
+	 * Résout Ax = b avec la méthode Gauss-Seidel multicolore pour une matrice
+	 * creuse par blocs.
+	 *
+	 * Les lignes de blocs sont relaxées couleur par couleur. Deux lignes de
+	 * blocs d'une même couleur n'ont aucun bloc hors diagonale en commun : elles
+	 * peuvent donc être mises à jour en parallèle tout en utilisant les valeurs
+	 * les plus récentes des autres couleurs, comme Gauss-Seidel.
+	 *
+	 * Les lignes de blocs de la couleur c sont
+	 * colorBlockRows[colorPointers[c]..colorPointers[c + 1][.
+	 */
+	inline void gaussSeidel(const BlockSparseMatrix<double>& A,
+	                        const Vector<double, Dynamic>& b,
+	                        Vector<double, Dynamic>& outSolution, int k_max,
+	                        const std::vector<int>& colorPointers,
+	                        const std::vector<int>& colorBlockRows,
+	                        SolverWorkspace& workspace, SolverStats* outStats = nullptr,
+	                        bool warmStart = false)
+	{
+		ASSERT(b.size() == A.rows(), "Trying to apply Gauss-Seidel solver with a vector of size incompatible with the matrix");
+		ASSERT(static_cast<int>(colorBlockRows.size()) == A.blockRows(), "Trying to apply Gauss-Seidel solver with a coloring of size incompatible with the matrix");
+
+		const auto startTime = omp_get_wtime();
+		const auto bNorm = b.norm();
+
+		workspace.resize(A.rows());
+		if (!warmStart || outSolution.size() != b.size())
+		{
+			copyInto(b, outSolution);
+		}
+
+		auto& lastSolution = workspace.lastSolution;
+
+		const auto numberOfColors = static_cast<int>(colorPointers.size()) - 1;
+		auto numberOfIterations = 0;
+		auto residual = -1.0;
+		auto checkResidual = false;
+		while (true)
+		{
+			copyInto(outSolution, lastSolution);
+
+			auto squaredResidual = 0.0;
+			auto squaredStep = 0.0;
+			auto squaredNorm = 0.0;
+
+			for (auto color = 0; color < numberOfColors; ++color)
+			{
+				#pragma omp parallel for reduction(+ : squaredResidual, squaredStep, squaredNorm)
+				for (auto p = colorPointers[color]; p < colorPointers[color + 1]; ++p)
+				{
+					relaxBlockRow(A, b, lastSolution, outSolution, colorBlockRows[p], squaredResidual, squaredStep, squaredNorm);
 				}
+			}
 
-				outSolution(i) /= A(i, i);
+			// Le résidu calculé est celui de l'itéré précédent
+			if (checkResidual && !(sqrt(squaredResidual) / bNorm > epsilon))
+			{
+				residual = sqrt(squaredResidual) / bNorm;
+				copyInto(lastSolution, outSolution);
+				break;
 			}
 
 			++numberOfIterations;
 
-		} while (numberOfIterations < k_max && (outSolution - lastSolution).norm() / outSolution.norm() > tau && (A * outSolution - b).norm() / b.norm() > epsilon);
+			if (!(numberOfIterations < k_max && sqrt(squaredStep) / sqrt(squaredNorm) > tau))
+			{
+				break;
+			}
+			checkResidual = true;
+		}
+
+		if (outStats != nullptr)
+		{
+			outStats->iterations = numberOfIterations;
+			outStats->residual = residual >= 0.0 ? residual : relativeResidual(A, b, outSolution);
+			outStats->time = omp_get_wtime() - startTime;
+		}
 	}
 
 	/**
@@ -119,7 +761,7 @@ namespace gti320
 	 * @param b b
 	 * @param outSolution x
 	 */
-	static void cholesky(const Matrix<double, Dynamic, Dynamic>& A,
+	inline void cholesky(const Matrix<double, Dynamic, Dynamic>& A,
 	                     const Vector<double, Dynamic>& b,
 	                     Vector<double, Dynamic>& outSolution)
 	{
@@ -184,4 +826,271 @@ namespace gti320
 			outSolution(i) /= cholesky(i, i);
 		}
 	}
+
+	/**
+	 * Résout Ax = b avec une factorisation de Cholesky creuse.
+	 *
+	 * L'analyse symbolique conservée dans `factorization` (ordonnancement et
+	 * structure de L) est réutilisée tant que la structure de A ne change pas;
+	 * seule la factorisation numérique est refaite.
+	 *
+	 * Retourne faux si A n'est pas définie positive.
+	 */
+	inline bool cholesky(const BlockSparseMatrix<double>& A,
+	                     const Vector<double, Dynamic>& b,
+	                     Vector<double, Dynamic>& outSolution,
+	                     SparseCholesky& factorization)
+	{
+		ASSERT(b.size() == A.rows(), "Trying to apply Cholesky solver with a vector of size incompatible with the matrix");
+
+		if (!factorization.compute(A))
+		{
+			return false;
+		}
+
+		factorization.solve(b, outSolution);
+		return true;
+	}
+
+	/**
+	 * Résout Ax = b en réutilisant, tant qu'il n'est pas périmé, le facteur de
+	 * Cholesky calculé lors d'une résolution précédente (voir `CachedCholesky`).
+	 *
+	 * Retourne faux si A doit être factorisée et n'est pas définie positive.
+	 */
+	inline bool cholesky(const BlockSparseMatrix<double>& A,
+	                     const Vector<double, Dynamic>& b,
+	                     Vector<double, Dynamic>& outSolution,
+	                     CachedCholesky& factorization, SolverStats* outStats = nullptr)
+	{
+		const auto startTime = omp_get_wtime();
+
+		if (!factorization.solve(A, b, outSolution))
+		{
+			return false;
+		}
+
+		if (outStats != nullptr)
+		{
+			outStats->refactored = factorization.lastSolveRefactored();
+			outStats->iterations = outStats->refactored ? 0 : factorization.refinementSteps();
+			outStats->residual = relativeResidual(A, b, outSolution);
+			outStats->time = omp_get_wtime() - startTime;
+		}
+		return true;
+	}
+
+	/**
+	 * Résout Ax = b avec la méthode du gradient conjugué préconditionné.
+	 *
+	 * A doit être symétrique définie positive, ce qui est le cas de la matrice
+	 * M - dt^2 df/dx de l'intégration d'Euler implicite. La matrice peut être
+	 * dense ou creuse par blocs.
+	 *
+	 * La solution initiale est nulle : puisque la matrice de masse contient des
+	 * valeurs très grandes pour les particules fixes, partir de b pourrait
+	 * provoquer un débordement lors du calcul du résidu initial.
+	 *
+	 * Les vecteurs de travail et le préconditionneur sont ceux de `workspace`.
+	 */
+	template <typename MatrixType>
+	void preconditionedConjugateGradient(const MatrixType& A,
+	                                     const Vector<double, Dynamic>& b,
+	                                     Vector<double, Dynamic>& outSolution, int k_max,
+	                                     ePreconditionerType preconditionerType,
+	                                     SolverWorkspace& workspace, SolverStats* outStats = nullptr)
+	{
+		ASSERT(A.rows() == A.cols(), "Trying to apply conjugate gradient solver with a non square matrix");
+		ASSERT(b.size() == A.rows(), "Trying to apply conjugate gradient solver with a vector of size incompatible with the matrix");
+
+		const auto startTime = omp_get_wtime();
+		const auto bNorm = b.norm();
+
+		outSolution.resize(b.size());
+		outSolution.setZero();
+
+		// b est nul : la solution est nulle et le résidu aussi
+		if (!(bNorm > 0.0))
+		{
+			if (outStats != nullptr)
+			{
+				outStats->iterations = 0;
+				outStats->residual = 0.0;
+				outStats->time = omp_get_wtime() - startTime;
+			}
+			return;
+		}
+
+		auto& preconditioner = workspace.preconditioner;
+		preconditioner.compute(A, preconditionerType);
+
+		workspace.resizeConjugateGradient(b.size());
+		auto& residual = workspace.residual;
+		auto& preconditionedResidual = workspace.preconditionedResidual;
+		auto& direction = workspace.direction;
+		auto& Ap = workspace.Ap;
+
+		copyInto(b, residual);
+		preconditioner.apply(residual, preconditionedResidual);
+		copyInto(preconditionedResidual, direction);
+
+		auto residualDotZ = residual.dot(preconditionedResidual);
+
+		auto numberOfIterations = 0;
+		while (numberOfIterations < k_max && residual.norm() > epsilon * bNorm)
+		{
+			gemv(1.0, A, direction, 0.0, Ap);
+			const auto alpha = residualDotZ / direction.dot(Ap);
+
+			outSolution = outSolution + alpha * direction;
+			residual = residual - alpha * Ap;
+
+			preconditioner.apply(residual, preconditionedResidual);
+			const auto newResidualDotZ = residual.dot(preconditionedResidual);
+			const auto beta = newResidualDotZ / residualDotZ;
+			residualDotZ = newResidualDotZ;
+
+			direction = preconditionedResidual + beta * direction;
+			++numberOfIterations;
+		}
+
+		if (outStats != nullptr)
+		{
+			outStats->iterations = numberOfIterations;
+			outStats->residual = residual.norm() / bNorm;
+			outStats->time = omp_get_wtime() - startTime;
+		}
+	}
+
+	/**
+	 * Résout Ax = b avec la méthode du gradient conjugué, sans préconditionneur.
+	 *
+	 * A doit être symétrique définie positive. La matrice peut être dense ou
+	 * creuse par blocs.
+	 *
+	 * Les particules fixes ont une masse immense : appliqué directement à A,
+	 * le produit p·Ap déborde sur leurs degrés de liberté. Les lignes dont la
+	 * diagonale dépasse sqrt(max) sont donc traitées comme des conditions de
+	 * Dirichlet : leur inconnue est fixée à b_i / A_ii et le gradient conjugué
+	 * ne travaille que sur les autres lignes, où le résidu et la direction
+	 * sont nuls. À la fin, ces inconnues sont corrigées à partir de la
+	 * solution des autres lignes pour que leur équation soit satisfaite.
+	 *
+	 * L'arrêt se fait sur le résidu relatif ||b - Ax|| / ||b|| des autres
+	 * lignes, qui est aussi le résidu rapporté.
+	 *
+	 * Les vecteurs de travail sont ceux de `workspace`.
+	 */
+	template <typename MatrixType>
+	void conjugateGradient(const MatrixType& A,
+	                       const Vector<double, Dynamic>& b,
+	                       Vector<double, Dynamic>& outSolution, int k_max,
+	                       SolverWorkspace& workspace, SolverStats* outStats = nullptr)
+	{
+		ASSERT(A.rows() == A.cols(), "Trying to apply conjugate gradient solver with a non square matrix");
+		ASSERT(b.size() == A.rows(), "Trying to apply conjugate gradient solver with a vector of size incompatible with the matrix");
+		ASSERT(A.rows() % 2 == 0, "Trying to apply conjugate gradient solver with a matrix of odd size");
+
+		const auto startTime = omp_get_wtime();
+		const auto size = A.rows();
+		const auto bNorm = b.norm();
+
+		outSolution.resize(size);
+		outSolution.setZero();
+
+		// b est nul : la solution est nulle et le résidu aussi
+		if (!(bNorm > 0.0))
+		{
+			if (outStats != nullptr)
+			{
+				outStats->iterations = 0;
+				outStats->residual = 0.0;
+				outStats->time = omp_get_wtime() - startTime;
+			}
+			return;
+		}
+
+		workspace.resizeConjugateGradient(size);
+		auto& dirichlet = workspace.dirichlet;
+		auto& residual = workspace.residual;
+		auto& direction = workspace.direction;
+		auto& Ap = workspace.Ap;
+
+		// Lignes de Dirichlet et valeur de leur inconnue
+		const auto dirichletThreshold = sqrt(std::numeric_limits<double>::max());
+		for (auto blockRow = 0; blockRow < size / 2; ++blockRow)
+		{
+			double block[4];
+			extractDiagonalBlock(A, blockRow, block);
+
+			const double diagonal[2] = { block[0], block[3] };
+			for (auto k = 0; k < 2; ++k)
+			{
+				const auto i = 2 * blockRow + k;
+				dirichlet[i] = diagonal[k] > dirichletThreshold;
+				if (dirichlet[i])
+				{
+					outSolution(i) = b(i) / diagonal[k];
+				}
+			}
+		}
+
+		// r = b - Ax
+		copyInto(b, residual);
+		gemv(-1.0, A, outSolution, 1.0, residual);
+		for (auto i = 0; i < size; ++i)
+		{
+			if (dirichlet[i])
+			{
+				residual(i) = 0.0;
+			}
+		}
+		copyInto(residual, direction);
+		auto squaredResidualNorm = residual.squaredNorm();
+
+		auto numberOfIterations = 0;
+		while (numberOfIterations < k_max && sqrt(squaredResidualNorm) > epsilon * bNorm)
+		{
+			gemv(1.0, A, direction, 0.0, Ap);
+			for (auto i = 0; i < size; ++i)
+			{
+				if (dirichlet[i])
+				{
+					Ap(i) = 0.0;
+				}
+			}
+			const auto alpha = squaredResidualNorm / direction.dot(Ap);
+
+			outSolution = outSolution + alpha * direction;
+			residual = residual - alpha * Ap;
+
+			const auto newSquaredResidualNorm = residual.squaredNorm();
+			const auto beta = newSquaredResidualNorm / squaredResidualNorm;
+			squaredResidualNorm = newSquaredResidualNorm;
+
+			direction = residual + beta * direction;
+			++numberOfIterations;
+		}
+
+		// Correction des inconnues de Dirichlet : x_i += (b - Ax)_i / A_ii. Le
+		// changement, de l'ordre de 1 / A_ii, est négligeable pour les autres
+		// lignes.
+		gemv(1.0, A, outSolution, 0.0, Ap);
+		for (auto i = 0; i < size; ++i)
+		{
+			if (dirichlet[i])
+			{
+				double block[4];
+				extractDiagonalBlock(A, i / 2, block);
+				outSolution(i) += (b(i) - Ap(i)) / block[3 * (i % 2)];
+			}
+		}
+
+		if (outStats != nullptr)
+		{
+			outStats->iterations = numberOfIterations;
+			outStats->residual = sqrt(squaredResidualNorm) / bNorm;
+			outStats->time = omp_get_wtime() - startTime;
+		}
+	}
 }
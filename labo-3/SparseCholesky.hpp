@@ -0,0 +1,644 @@
+#pragma once
+
+/**
+ * @file SparseCholesky.hpp
+ *
+ * @brief Factorisation de Cholesky creuse pour les matrices creuses par blocs
+ *        2x2 symétriques définies positives.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "BlockSparseMatrix.h"
+#include "Math3D.h"
+
+namespace gti320
+{
+	/**
+	 * Factorisation de Cholesky creuse P A P^T = L L^T.
+	 *
+	 * La factorisation est séparée en deux étapes :
+	 *
+	 * - L'analyse symbolique (`analyze`) calcule un ordonnancement qui réduit le
+	 *   remplissage (degré minimum sur le graphe des particules), l'arbre
+	 *   d'élimination et la structure de L. Elle ne dépend que de la structure
+	 *   de A et n'est refaite que lorsque la topologie change.
+	 *
+	 * - La factorisation numérique (`factorize`) calcule les valeurs de L
+	 *   colonne par colonne (algorithme « up-looking ») dans la structure
+	 *   précalculée, sans aucune allocation.
+	 */
+	class SparseCholesky
+	{
+	private:
+		int m_size; // Dimension de la matrice (nombre de lignes scalaires)
+		bool m_analyzed; // Vrai lorsque l'analyse symbolique a été faite
+		bool m_factorized; // Vrai lorsque la factorisation numérique a réussi
+
+		// Structure de la matrice analysée, pour détecter un changement de topologie
+		std::vector<int> m_patternRowPointers;
+		std::vector<int> m_patternColIndices;
+
+		std::vector<int> m_permutation; // m_permutation[k] : ligne de A placée à la ligne k de PAP^T
+		std::vector<int> m_parent; // Arbre d'élimination de PAP^T
+
+		// Triangle supérieur de C = PAP^T stocké par colonnes. m_upperMap donne
+		// l'indice de chaque élément dans les valeurs de la matrice creuse par blocs.
+		std::vector<int> m_upperColPointers;
+		std::vector<int> m_upperRowIndices;
+		std::vector<int> m_upperMap;
+		std::vector<double> m_upperValues;
+
+		// Facteur L stocké par colonnes, l'élément diagonal en premier
+		std::vector<int> m_lowerColPointers;
+		std::vector<int> m_lowerRowIndices;
+		std::vector<double> m_lowerValues;
+
+		// Espaces de travail de la factorisation numérique et de la résolution
+		std::vector<int> m_stack;
+		std::vector<int> m_marks;
+		std::vector<int> m_nextInColumn;
+		std::vector<double> m_work;
+
+	public:
+		SparseCholesky() : m_size(0), m_analyzed(false), m_factorized(false)
+		{
+		}
+
+		/**
+		 * Indique si la structure de A correspond à celle de la dernière analyse symbolique
+		 */
+		bool isAnalyzedFor(const BlockSparseMatrix<double>& A) const
+		{
+			return m_analyzed && A.rowPointers() == m_patternRowPointers && A.colIndices() == m_patternColIndices;
+		}
+
+		/**
+		 * Analyse symbolique : ordonnancement, arbre d'élimination et structure de L.
+		 */
+		void analyze(const BlockSparseMatrix<double>& A)
+		{
+			m_size = A.rows();
+			m_patternRowPointers = A.rowPointers();
+			m_patternColIndices = A.colIndices();
+
+			computeOrdering(A);
+			buildPermutedUpperTriangle(A);
+			computeEliminationTree();
+			computeLowerStructure();
+
+			m_analyzed = true;
+			m_factorized = false;
+		}
+
+		/**
+		 * Factorisation numérique de A. L'analyse symbolique doit avoir été faite
+		 * pour une matrice de même structure.
+		 *
+		 * Retourne faux si la matrice n'est pas définie positive.
+		 */
+		bool factorize(const BlockSparseMatrix<double>& A)
+		{
+			ASSERT(m_analyzed, "Trying to factorize a matrix before its symbolic analysis");
+
+			const auto& values = A.values();
+			for (auto p = 0; p < static_cast<int>(m_upperMap.size()); ++p)
+			{
+				m_upperValues[p] = values[m_upperMap[p]];
+			}
+
+			m_factorized = numericFactorization();
+			return m_factorized;
+		}
+
+		/**
+		 * Analyse symbolique (seulement si la structure a changé) suivie de la
+		 * factorisation numérique.
+		 */
+		bool compute(const BlockSparseMatrix<double>& A)
+		{
+			if (!isAnalyzedFor(A))
+			{
+				analyze(A);
+			}
+			return factorize(A);
+		}
+
+		/**
+		 * Résout Ax = b à l'aide de la factorisation : x = P^T L^-T L^-1 P b
+		 */
+		void solve(const Vector<double, Dynamic>& b, Vector<double, Dynamic>& outSolution)
+		{
+			ASSERT(m_factorized, "Trying to solve a system with an invalid Cholesky factorization");
+			ASSERT(b.size() == m_size, "Trying to solve a system with a vector of incompatible size");
+
+			for (auto k = 0; k < m_size; ++k)
+			{
+				m_work[k] = b(m_permutation[k]);
+			}
+
+			// Résout Ly = Pb
+			for (auto j = 0; j < m_size; ++j)
+			{
+				m_work[j] /= m_lowerValues[m_lowerColPointers[j]];
+				for (auto p = m_lowerColPointers[j] + 1; p < m_lowerColPointers[j + 1]; ++p)
+				{
+					m_work[m_lowerRowIndices[p]] -= m_lowerValues[p] * m_work[j];
+				}
+			}
+
+			// Résout L^T z = y
+			for (auto j = m_size - 1; j >= 0; --j)
+			{
+				for (auto p = m_lowerColPointers[j] + 1; p < m_lowerColPointers[j + 1]; ++p)
+				{
+					m_work[j] -= m_lowerValues[p] * m_work[m_lowerRowIndices[p]];
+				}
+				m_work[j] /= m_lowerValues[m_lowerColPointers[j]];
+			}
+
+			outSolution.resize(m_size);
+			for (auto k = 0; k < m_size; ++k)
+			{
+				outSolution(m_permutation[k]) = m_work[k];
+			}
+		}
+
+		/**
+		 * Nombre d'éléments non nuls du facteur L
+		 */
+		inline int nonZeros() const { return m_analyzed ? m_lowerColPointers[m_size] : 0; }
+
+	private:
+		/**
+		 * Calcule un ordonnancement de degré minimum sur le graphe des blocs (les
+		 * particules), puis l'étend aux deux degrés de liberté de chaque particule.
+		 *
+		 * Le graphe d'élimination est conservé explicitement : lorsqu'un noeud est
+		 * éliminé, ses voisins forment une clique. Le noeud de plus petit degré est
+		 * choisi à chaque étape à l'aide d'une file de priorité dont les entrées
+		 * périmées sont ignorées.
+		 */
+		void computeOrdering(const BlockSparseMatrix<double>& A)
+		{
+			const auto blockRows = A.blockRows();
+
+			std::vector<std::vector<int>> adjacency(blockRows);
+			for (auto blockRow = 0; blockRow < blockRows; ++blockRow)
+			{
+				for (auto k = A.blockRowBegin(blockRow); k < A.blockRowEnd(blockRow); ++k)
+				{
+					if (A.blockCol(k) != blockRow)
+					{
+						adjacency[blockRow].push_back(A.blockCol(k));
+					}
+				}
+			}
+
+			typedef std::pair<int, int> DegreeAndNode;
+			std::priority_queue<DegreeAndNode, std::vector<DegreeAndNode>, std::greater<DegreeAndNode>> queue;
+			for (auto node = 0; node < blockRows; ++node)
+			{
+				queue.emplace(static_cast<int>(adjacency[node].size()), node);
+			}
+
+			std::vector<char> eliminated(blockRows, 0);
+			std::vector<int> blockPermutation;
+			blockPermutation.reserve(blockRows);
+			std::vector<int> merged;
+
+			while (!queue.empty())
+			{
+				const auto degreeAndNode = queue.top();
+				queue.pop();
+
+				const auto pivot = degreeAndNode.second;
+				if (eliminated[pivot] || degreeAndNode.first != static_cast<int>(adjacency[pivot].size()))
+				{
+					continue;
+				}
+
+				eliminated[pivot] = 1;
+				blockPermutation.push_back(pivot);
+
+				// Les voisins du pivot deviennent une clique et le pivot est retiré du graphe
+				const auto& neighbors = adjacency[pivot];
+				for (int neighbor : neighbors)
+				{
+					auto& neighborAdjacency = adjacency[neighbor];
+
+					merged.clear();
+					std::set_union(neighborAdjacency.begin(), neighborAdjacency.end(), neighbors.begin(), neighbors.end(), std::back_inserter(merged));
+					merged.erase(std::remove_if(merged.begin(), merged.end(), [pivot, neighbor](int node) { return node == pivot || node == neighbor; }), merged.end());
+
+					neighborAdjacency.swap(merged);
+					queue.emplace(static_cast<int>(neighborAdjacency.size()), neighbor);
+				}
+
+				std::vector<int>().swap(adjacency[pivot]);
+			}
+
+			m_permutation.resize(m_size);
+			for (auto k = 0; k < blockRows; ++k)
+			{
+				m_permutation[2 * k] = 2 * blockPermutation[k];
+				m_permutation[2 * k + 1] = 2 * blockPermutation[k] + 1;
+			}
+		}
+
+		/**
+		 * Construit la structure du triangle supérieur de C = PAP^T par colonnes,
+		 * ainsi que la correspondance entre ses éléments et les valeurs de A.
+		 */
+		void buildPermutedUpperTriangle(const BlockSparseMatrix<double>& A)
+		{
+			std::vector<int> inversePermutation(m_size);
+			for (auto k = 0; k < m_size; ++k)
+			{
+				inversePermutation[m_permutation[k]] = k;
+			}
+
+			// Compte le nombre d'éléments de chaque colonne, puis les place
+			m_upperColPointers.assign(m_size + 1, 0);
+			for (auto pass = 0; pass < 2; ++pass)
+			{
+				std::vector<int> next(m_upperColPointers.begin(), m_upperColPointers.end() - 1);
+
+				for (auto blockRow = 0; blockRow < A.blockRows(); ++blockRow)
+				{
+					for (auto k = A.blockRowBegin(blockRow); k < A.blockRowEnd(blockRow); ++k)
+					{
+						for (auto element = 0; element < 4; ++element)
+						{
+							const auto row = inversePermutation[2 * blockRow + element / 2];
+							const auto col = inversePermutation[2 * A.blockCol(k) + element % 2];
+							if (row > col)
+							{
+								continue;
+							}
+
+							if (pass == 0)
+							{
+								++m_upperColPointers[col + 1];
+							}
+							else
+							{
+								const auto p = next[col]++;
+								m_upperRowIndices[p] = row;
+								m_upperMap[p] = 4 * k + element;
+							}
+						}
+					}
+				}
+
+				if (pass == 0)
+				{
+					for (auto col = 0; col < m_size; ++col)
+					{
+						m_upperColPointers[col + 1] += m_upperColPointers[col];
+					}
+					m_upperRowIndices.resize(m_upperColPointers[m_size]);
+					m_upperMap.resize(m_upperColPointers[m_size]);
+					m_upperValues.resize(m_upperColPointers[m_size]);
+				}
+			}
+		}
+
+		/**
+		 * Calcule l'arbre d'élimination de C à partir de son triangle supérieur.
+		 */
+		void computeEliminationTree()
+		{
+			std::vector<int> ancestor(m_size, -1);
+			m_parent.assign(m_size, -1);
+
+			for (auto k = 0; k < m_size; ++k)
+			{
+				for (auto p = m_upperColPointers[k]; p < m_upperColPointers[k + 1]; ++p)
+				{
+					// On remonte de i jusqu'à la racine de son sous-arbre en compressant le chemin
+					auto i = m_upperRowIndices[p];
+					while (i != -1 && i < k)
+					{
+						const auto next = ancestor[i];
+						ancestor[i] = k;
+						if (next == -1)
+						{
+							m_parent[i] = k;
+						}
+						i = next;
+					}
+				}
+			}
+		}
+
+		/**
+		 * Parcourt l'arbre d'élimination pour trouver la structure de la ligne k
+		 * de L. Les indices sont placés dans m_stack[top..m_size[ et l'indice top
+		 * est retourné. Les marques de m_marks valent k pour les noeuds visités.
+		 */
+		int reachRow(int k)
+		{
+			auto top = m_size;
+			m_marks[k] = k;
+
+			for (auto p = m_upperColPointers[k]; p < m_upperColPointers[k + 1]; ++p)
+			{
+				auto i = m_upperRowIndices[p];
+				if (i > k)
+				{
+					continue;
+				}
+
+				// Le chemin est empilé au bas de la pile, puis déplacé vers le haut
+				// afin que les indices soient en ordre topologique.
+				auto length = 0;
+				for (; m_marks[i] != k; i = m_parent[i])
+				{
+					m_stack[length++] = i;
+					m_marks[i] = k;
+				}
+
+				while (length > 0)
+				{
+					m_stack[--top] = m_stack[--length];
+				}
+			}
+
+			return top;
+		}
+
+		/**
+		 * Calcule le nombre d'éléments de chaque colonne de L et alloue sa structure.
+		 */
+		void computeLowerStructure()
+		{
+			m_stack.resize(m_size);
+			m_nextInColumn.resize(m_size);
+			m_marks.assign(m_size, -1);
+			m_work.assign(m_size, 0.0);
+
+			// Chaque colonne contient au moins son élément diagonal
+			std::vector<int> counts(m_size, 1);
+			for (auto k = 0; k < m_size; ++k)
+			{
+				for (auto top = reachRow(k); top < m_size; ++top)
+				{
+					++counts[m_stack[top]];
+				}
+			}
+
+			m_lowerColPointers.assign(m_size + 1, 0);
+			for (auto col = 0; col < m_size; ++col)
+			{
+				m_lowerColPointers[col + 1] = m_lowerColPointers[col] + counts[col];
+			}
+
+			m_lowerRowIndices.resize(m_lowerColPointers[m_size]);
+			m_lowerValues.resize(m_lowerColPointers[m_size]);
+		}
+
+		/**
+		 * Factorisation numérique « up-looking » : la ligne k de L est calculée
+		 * par une résolution triangulaire creuse dont la structure est donnée par
+		 * l'arbre d'élimination.
+		 */
+		bool numericFactorization()
+		{
+			// m_nextInColumn[j] : prochaine position libre dans la colonne j de L
+			std::copy(m_lowerColPointers.begin(), m_lowerColPointers.end() - 1, m_nextInColumn.begin());
+			std::fill(m_marks.begin(), m_marks.end(), -1);
+
+			for (auto k = 0; k < m_size; ++k)
+			{
+				const auto top = reachRow(k);
+
+				// x = C(0:k, k), dispersé dans m_work
+				m_work[k] = 0.0;
+				for (auto p = m_upperColPointers[k]; p < m_upperColPointers[k + 1]; ++p)
+				{
+					if (m_upperRowIndices[p] <= k)
+					{
+						m_work[m_upperRowIndices[p]] = m_upperValues[p];
+					}
+				}
+
+				auto diagonal = m_work[k];
+				m_work[k] = 0.0;
+
+				for (auto t = top; t < m_size; ++t)
+				{
+					const auto i = m_stack[t];
+
+					// L(k, i) = x(i) / L(i, i)
+					const auto lki = m_work[i] / m_lowerValues[m_lowerColPointers[i]];
+					m_work[i] = 0.0;
+
+					for (auto p = m_lowerColPointers[i] + 1; p < m_nextInColumn[i]; ++p)
+					{
+						m_work[m_lowerRowIndices[p]] -= m_lowerValues[p] * lki;
+					}
+
+					diagonal -= lki * lki;
+
+					const auto p = m_nextInColumn[i]++;
+					m_lowerRowIndices[p] = k;
+					m_lowerValues[p] = lki;
+				}
+
+				if (!(diagonal > 0.0))
+				{
+					return false;
+				}
+
+				const auto p = m_nextInColumn[k]++;
+				m_lowerRowIndices[p] = k;
+				m_lowerValues[p] = sqrt(diagonal);
+			}
+
+			return true;
+		}
+	};
+
+	/**
+	 * Résolution de Ax = b qui réutilise une factorisation de Cholesky d'un pas
+	 * de temps à l'autre.
+	 *
+	 * Lorsque la rigidité et le pas de temps sont constants, A varie peu d'un
+	 * pas à l'autre. La factorisation numérique n'est donc refaite que :
+	 *
+	 * - lorsque la structure de A a changé;
+	 * - après `refactorInterval` résolutions avec le même facteur;
+	 * - lorsque la variation relative de A depuis la dernière factorisation
+	 *   dépasse `changeThreshold`.
+	 *
+	 * Sinon, la solution obtenue avec l'ancien facteur est corrigée par
+	 * quelques itérations de raffinement itératif : x += L^-T L^-1 (b - Ax).
+	 */
+	class CachedCholesky
+	{
+	private:
+		SparseCholesky m_factorization;
+		bool m_valid; // Vrai lorsque m_factorization contient un facteur utilisable
+
+		int m_refactorInterval; // Nombre maximal de résolutions avec le même facteur
+		double m_changeThreshold; // Variation relative de A qui force une nouvelle factorisation
+		int m_refinementSteps; // Nombre d'itérations de raffinement lorsque le facteur est réutilisé
+
+		int m_solvesSinceFactorization;
+		bool m_lastSolveRefactored;
+
+		// Valeurs de A et racines de sa diagonale au moment de la factorisation
+		std::vector<double> m_factoredValues;
+		std::vector<double> m_factoredSqrtDiagonal;
+
+		// Espaces de travail du raffinement itératif
+		Vector<double, Dynamic> m_residual;
+		Vector<double, Dynamic> m_correction;
+
+	public:
+		CachedCholesky(int refactorInterval = 10, double changeThreshold = 0.05, int refinementSteps = 2)
+			: m_factorization(), m_valid(false),
+			  m_refactorInterval(refactorInterval), m_changeThreshold(changeThreshold), m_refinementSteps(refinementSteps),
+			  m_solvesSinceFactorization(0), m_lastSolveRefactored(false)
+		{
+		}
+
+		inline void setRefactorInterval(int refactorInterval) { m_refactorInterval = refactorInterval; }
+		inline void setChangeThreshold(double changeThreshold) { m_changeThreshold = changeThreshold; }
+		inline void setRefinementSteps(int refinementSteps) { m_refinementSteps = refinementSteps; }
+
+		inline int refactorInterval() const { return m_refactorInterval; }
+		inline double changeThreshold() const { return m_changeThreshold; }
+		inline int refinementSteps() const { return m_refinementSteps; }
+
+		/**
+		 * Indique si la dernière résolution a nécessité une nouvelle factorisation
+		 */
+		inline bool lastSolveRefactored() const { return m_lastSolveRefactored; }
+
+		/**
+		 * Force une nouvelle factorisation à la prochaine résolution.
+		 */
+		inline void invalidate() { m_valid = false; }
+
+		/**
+		 * Résout Ax = b en réutilisant le facteur courant lorsque c'est possible.
+		 *
+		 * Retourne faux si A doit être factorisée et n'est pas définie positive.
+		 */
+		bool solve(const BlockSparseMatrix<double>& A, const Vector<double, Dynamic>& b, Vector<double, Dynamic>& outSolution)
+		{
+			ASSERT(b.size() == A.rows(), "Trying to apply Cholesky solver with a vector of size incompatible with the matrix");
+
+			m_lastSolveRefactored = needsFactorization(A);
+			if (m_lastSolveRefactored)
+			{
+				if (!m_factorization.compute(A))
+				{
+					m_valid = false;
+					return false;
+				}
+
+				m_valid = true;
+				m_solvesSinceFactorization = 0;
+				m_factoredValues = A.values();
+				m_factoredSqrtDiagonal.resize(A.rows());
+				for (auto blockRow = 0; blockRow < A.blockRows(); ++blockRow)
+				{
+					const double* diagonal = A.block(A.diagonalBlock(blockRow));
+					m_factoredSqrtDiagonal[2 * blockRow] = sqrt(diagonal[0]);
+					m_factoredSqrtDiagonal[2 * blockRow + 1] = sqrt(diagonal[3]);
+				}
+			}
+
+			++m_solvesSinceFactorization;
+			m_factorization.solve(b, outSolution);
+
+			if (!m_lastSolveRefactored)
+			{
+				for (auto step = 0; step < m_refinementSteps; ++step)
+				{
+					computeResidual(A, b, outSolution);
+					m_factorization.solve(m_residual, m_correction);
+					for (auto i = 0; i < outSolution.size(); ++i)
+					{
+						outSolution(i) += m_correction(i);
+					}
+				}
+			}
+
+			return true;
+		}
+
+	private:
+		/**
+		 * Applique la politique de péremption du facteur.
+		 *
+		 * La variation de A est mesurée élément par élément relativement à sa
+		 * diagonale, soit max |dA(i, j)| / sqrt(A(i, i) A(j, j)). Cette mesure
+		 * ne dépend pas de l'échelle des lignes : les particules fixes, dont la
+		 * masse est immense, ne masquent pas la variation des autres.
+		 */
+		bool needsFactorization(const BlockSparseMatrix<double>& A) const
+		{
+			if (!m_valid || !m_factorization.isAnalyzedFor(A) || m_solvesSinceFactorization >= m_refactorInterval)
+			{
+				return true;
+			}
+
+			const auto& values = A.values();
+			for (auto blockRow = 0; blockRow < A.blockRows(); ++blockRow)
+			{
+				for (auto k = A.blockRowBegin(blockRow); k < A.blockRowEnd(blockRow); ++k)
+				{
+					const auto col = A.blockCol(k);
+					for (auto element = 0; element < 4; ++element)
+					{
+						const auto i = 2 * blockRow + element / 2;
+						const auto j = 2 * col + element % 2;
+						const auto change = std::abs(values[4 * k + element] - m_factoredValues[4 * k + element]);
+						if (!(change <= m_changeThreshold * m_factoredSqrtDiagonal[i] * m_factoredSqrtDiagonal[j]))
+						{
+							return true;
+						}
+					}
+				}
+			}
+
+			return false;
+		}
+
+		/**
+		 * Calcule m_residual = b - Ax sans allocation.
+		 */
+		void computeResidual(const BlockSparseMatrix<double>& A, const Vector<double, Dynamic>& b, const Vector<double, Dynamic>& x)
+		{
+			m_residual.resize(A.rows());
+			for (auto blockRow = 0; blockRow < A.blockRows(); ++blockRow)
+			{
+				double r0 = b(2 * blockRow);
+				double r1 = b(2 * blockRow + 1);
+				for (auto k = A.blockRowBegin(blockRow); k < A.blockRowEnd(blockRow); ++k)
+				{
+					const double* block = A.block(k);
+					const auto j = 2 * A.blockCol(k);
+					r0 -= block[0] * x(j) + block[1] * x(j + 1);
+					r1 -= block[2] * x(j) + block[3] * x(j + 1);
+				}
+				m_residual(2 * blockRow) = r0;
+				m_residual(2 * blockRow + 1) = r1;
+			}
+		}
+	};
+}
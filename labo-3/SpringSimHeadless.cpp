@@ -0,0 +1,221 @@
+/**
+ * @file SpringSimHeadless.cpp
+ *
+ * @brief Simulation d'un système masse-ressort sans affichage : construit un
+ * modèle, effectue un nombre donné de pas et affiche le temps passé dans
+ * chacune des étapes d'un pas.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include "Simulator.h"
+
+#include <omp.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace gti320;
+
+namespace
+{
+	/**
+	 * Paramètres de la simulation (voir printUsage)
+	 */
+	struct Options
+	{
+		eSceneType scene = kHangingCloth;
+		int size = 16;
+		int steps = 1000;
+		double dt = 0.01;
+		double stiffness = 300.0;
+		int kmax = 10;
+		eSolverType solver = kGaussSeidel;
+		ePreconditionerType preconditioner = kBlockJacobiPreconditioner;
+		eWarmStartType warmStart = kWarmStartExtrapolated;
+	};
+
+	void printUsage(const char* program)
+	{
+		printf("Usage : %s [options]\n", program);
+		printf("  --scene cloth|beam|rope|custom   modele simule (defaut : cloth)\n");
+		printf("  --size N                         tissu de N x N particules (defaut : 16)\n");
+		printf("  --steps N                        nombre de pas (defaut : 1000)\n");
+		printf("  --dt T                           intervalle de temps d'un pas, en secondes (defaut : 0.01)\n");
+		printf("  --stiffness K                    rigidite des ressorts (defaut : 300)\n");
+		printf("  --solver gs|gs-color|jacobi|cholesky|cg|pcg|none   (defaut : gs)\n");
+		printf("  --kmax N                         nombre maximal d'iterations (defaut : 10)\n");
+		printf("  --preconditioner block-jacobi|jacobi               (defaut : block-jacobi)\n");
+		printf("  --warm-start extrapolated|previous|none            (defaut : extrapolated)\n");
+	}
+
+	bool parseSolver(const char* name, eSolverType& outSolver)
+	{
+		static const std::pair<const char*, eSolverType> solvers[] = {
+			{ "gs", kGaussSeidel }, { "gs-color", kColoredGaussSeidel }, { "jacobi", kJacobi },
+			{ "cholesky", kCholesky }, { "cg", kConjugateGradient }, { "pcg", kPCG }, { "none", kNone } };
+
+		for (const auto& solver : solvers)
+		{
+			if (strcmp(name, solver.first) == 0)
+			{
+				outSolver = solver.second;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Lecture des arguments de la ligne de commande. Retourne false si un
+	 * argument est invalide.
+	 */
+	bool parseOptions(int argc, char** argv, Options& outOptions)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const char* option = argv[i];
+			if (i + 1 >= argc)
+			{
+				return false;
+			}
+			const char* value = argv[++i];
+
+			if (strcmp(option, "--scene") == 0)
+			{
+				if (strcmp(value, "cloth") == 0) outOptions.scene = kHangingCloth;
+				else if (strcmp(value, "beam") == 0) outOptions.scene = kBeam;
+				else if (strcmp(value, "rope") == 0) outOptions.scene = kHangingRope;
+				else if (strcmp(value, "custom") == 0) outOptions.scene = kVotreExemple;
+				else return false;
+			}
+			else if (strcmp(option, "--size") == 0)
+			{
+				outOptions.size = atoi(value);
+			}
+			else if (strcmp(option, "--steps") == 0)
+			{
+				outOptions.steps = atoi(value);
+			}
+			else if (strcmp(option, "--dt") == 0)
+			{
+				outOptions.dt = atof(value);
+			}
+			else if (strcmp(option, "--stiffness") == 0)
+			{
+				outOptions.stiffness = atof(value);
+			}
+			else if (strcmp(option, "--kmax") == 0)
+			{
+				outOptions.kmax = atoi(value);
+			}
+			else if (strcmp(option, "--solver") == 0)
+			{
+				if (!parseSolver(value, outOptions.solver))
+				{
+					return false;
+				}
+			}
+			else if (strcmp(option, "--preconditioner") == 0)
+			{
+				if (strcmp(value, "block-jacobi") == 0) outOptions.preconditioner = kBlockJacobiPreconditioner;
+				else if (strcmp(value, "jacobi") == 0) outOptions.preconditioner = kJacobiPreconditioner;
+				else return false;
+			}
+			else if (strcmp(option, "--warm-start") == 0)
+			{
+				if (strcmp(value, "extrapolated") == 0) outOptions.warmStart = kWarmStartExtrapolated;
+				else if (strcmp(value, "previous") == 0) outOptions.warmStart = kWarmStartPrevious;
+				else if (strcmp(value, "none") == 0) outOptions.warmStart = kNoWarmStart;
+				else return false;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return outOptions.size > 1 && outOptions.steps >= 0 && outOptions.dt > 0.0 && outOptions.kmax > 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	Simulator simulator;
+	simulator.setStiffness(options.stiffness);
+	simulator.setMaxIterations(options.kmax);
+	simulator.setSolverType(options.solver);
+	simulator.setPreconditionerType(options.preconditioner);
+	simulator.setWarmStartType(options.warmStart);
+	simulator.loadScene(options.scene, options.size);
+
+	const ParticleSystem& particleSystem = simulator.getParticleSystem();
+	printf("%d particles, %d springs, %d steps, dt = %g, %d thread(s)\n", particleSystem.getParticleCount(),
+	       static_cast<int>(particleSystem.getSprings().size()), options.steps, options.dt, omp_get_max_threads());
+
+	long long totalIterations = 0;
+	int factorizations = 0;
+
+	const double startTime = omp_get_wtime();
+	for (int step = 0; step < options.steps; ++step)
+	{
+		simulator.step(options.dt);
+		const SolverStats& solverStats = simulator.getSolverStats();
+		totalIterations += solverStats.iterations;
+		factorizations += solverStats.refactored ? 1 : 0;
+	}
+	const double totalTime = omp_get_wtime() - startTime;
+
+	// Rapport : temps total et moyen de chacune des étapes sur toute la
+	// simulation; minimum et 99e centile sur la fenêtre des derniers pas, dont
+	// la taille ne dépend pas de la durée de la simulation
+	const StepProfiler& profiler = simulator.getProfiler();
+	const StepProfile profile = profiler.summarize();
+	const auto printTiming = [totalTime](const char* name, const TimingStats& stats, const TimingSummary& summary)
+	{
+		const double mean = stats.totalCount() > 0 ? stats.total() / stats.totalCount() : 0.0;
+		printf("%-18s %10.4f %10.4f %10.4f %10.4f %7.1f%%\n", name, stats.total(), 1000.0 * mean, 1000.0 * summary.min, 1000.0 * summary.p99,
+		       totalTime > 0.0 ? 100.0 * stats.total() / totalTime : 0.0);
+	};
+
+	printf("\nmin and p99 over the last %d steps\n", profile.step.count);
+	printf("%-18s %10s %10s %10s %10s %8s\n", "phase", "total (s)", "mean (ms)", "min (ms)", "p99 (ms)", "share");
+	for (int phase = 0; phase < kNumberOfStepPhases; ++phase)
+	{
+		printTiming(StepProfiler::getPhaseName(static_cast<eStepPhase>(phase)), profiler.phase(static_cast<eStepPhase>(phase)), profile.phases[phase]);
+	}
+	printTiming("step", profiler.step(), profile.step);
+
+	const int steps = options.steps > 0 ? options.steps : 1;
+	printf("\n%.1f steps/s\n", totalTime > 0.0 ? options.steps / totalTime : 0.0);
+	if (options.solver != kNone)
+	{
+		printf("%.2f solver iterations per step, last relative residual %.2e\n", static_cast<double>(totalIterations) / steps, simulator.getSolverStats().residual);
+	}
+	if (options.solver == kCholesky)
+	{
+		printf("%d factorizations, refinement iterations otherwise\n", factorizations);
+	}
+
+	// Somme pondérée des positions finales : permet de vérifier que deux
+	// exécutions (ou deux versions du code) donnent la même simulation
+	const Vector<double, Dynamic>& x = particleSystem.getPositions();
+	double checksum = 0.0;
+	for (int i = 0; i < x.size(); ++i)
+	{
+		checksum += x(i) * (i + 1);
+	}
+	printf("position checksum %.10f\n", checksum);
+
+	return 0;
+}
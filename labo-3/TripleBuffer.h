@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @file TripleBuffer.h
+ *
+ * @brief Triple tampon sans verrou entre un producteur et un consommateur.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <atomic>
+
+namespace gti320
+{
+	/**
+	 * Triple tampon : un fil d'exécution producteur publie des valeurs qu'un
+	 * fil consommateur lit, sans verrou et sans que l'un n'attende l'autre.
+	 *
+	 * Le producteur écrit dans le tampon arrière (back) puis le publie : il est
+	 * échangé avec le tampon du milieu. Le consommateur récupère le tampon du
+	 * milieu avec update() lorsqu'une nouvelle valeur a été publiée, et lit le
+	 * tampon avant (front) aussi longtemps qu'il le souhaite. Les valeurs
+	 * intermédiaires publiées entre deux appels à update() sont perdues; le
+	 * consommateur voit toujours la plus récente.
+	 *
+	 * Les tampons sont réutilisés : le producteur doit réécrire tout le
+	 * contenu du tampon arrière, qui contient une ancienne valeur, avant de le
+	 * publier.
+	 */
+	template <typename T>
+	class TripleBuffer
+	{
+	private:
+		static const int kIndexMask = 3;
+		static const int kFreshBit = 4; // une valeur a été publiée depuis le dernier update()
+
+		T m_buffers[3];
+		std::atomic<int> m_middle; // indice du tampon du milieu, avec kFreshBit
+		int m_back;  // tampon du producteur
+		int m_front; // tampon du consommateur
+
+	public:
+		TripleBuffer() : m_middle(1), m_back(0), m_front(2)
+		{
+		}
+
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+		/**
+		 * Tampon dans lequel écrit le producteur
+		 */
+		T& back() { return m_buffers[m_back]; }
+
+		/**
+		 * Publie le tampon arrière (producteur)
+		 */
+		void publish()
+		{
+			m_back = m_middle.exchange(m_back | kFreshBit, std::memory_order_acq_rel) & kIndexMask;
+		}
+
+		/**
+		 * Récupère la dernière valeur publiée, s'il y en a une nouvelle
+		 * (consommateur). Retourne vrai si le tampon avant a changé.
+		 */
+		bool update()
+		{
+			if ((m_middle.load(std::memory_order_acquire) & kFreshBit) == 0)
+			{
+				return false;
+			}
+			m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndexMask;
+			return true;
+		}
+
+		/**
+		 * Tampon lu par le consommateur
+		 */
+		const T& front() const { return m_buffers[m_front]; }
+	};
+}
@@ -0,0 +1,164 @@
+/**
+ * @file Solvers_Test.cpp
+ *
+ * @brief Unit tests for the iterative solvers.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+#include "../Solvers.hpp"
+#include "TestSystems.h"
+
+using namespace gti320;
+
+namespace
+{
+	const int kBlockRows = 8;
+	const int kMaxIterations = 200;
+
+	/*
+	 * Vérifie que la solution est proche de celle de Cholesky dense et que le
+	 * résidu rapporté est sous le seuil de convergence
+	 */
+	void expectConverged(const BlockSparseMatrix<double>& A, const Vector<double, Dynamic>& b,
+	                     const Vector<double, Dynamic>& x, const SolverStats& stats, double tolerance)
+	{
+		Vector<double, Dynamic> expected;
+		cholesky(A.toDense(), b, expected);
+
+		ASSERT_EQ(expected.size(), x.size());
+		for (auto i = 0; i < x.size(); ++i)
+		{
+			EXPECT_NEAR(expected(i), x(i), tolerance * expected.norm());
+		}
+
+		EXPECT_GT(stats.iterations, 0);
+		EXPECT_LT(stats.iterations, kMaxIterations);
+		EXPECT_LE(stats.residual, tolerance);
+	}
+}
+
+/*
+ * Teste la convergence du gradient conjugué et que le résidu rapporté est
+ * celui de la solution retournée
+ */
+TEST(TestSolvers, ConjugateGradient_Converges)
+{
+	const auto A = createChainMatrix(kBlockRows);
+	const auto b = createRightHandSide(A.rows());
+
+	Vector<double, Dynamic> x;
+	SolverWorkspace workspace;
+	SolverStats stats;
+	conjugateGradient(A, b, x, kMaxIterations, workspace, &stats);
+
+	expectConverged(A, b, x, stats, epsilon);
+	EXPECT_NEAR(relativeResidual(A, b, x), stats.residual, 1e-10);
+}
+
+/*
+ * Teste le gradient conjugué lorsqu'une particule est fixe : sa masse immense
+ * est traitée comme une condition de Dirichlet
+ */
+TEST(TestSolvers, ConjugateGradient_FixedParticle_Converges)
+{
+	auto A = createChainMatrix(kBlockRows);
+	double* fixedBlock = A.block(A.diagonalBlock(0));
+	fixedBlock[0] = fixedBlock[3] = std::numeric_limits<double>::max();
+	fixedBlock[1] = fixedBlock[2] = 0.0;
+	const auto b = createRightHandSide(A.rows());
+
+	Vector<double, Dynamic> x;
+	SolverWorkspace workspace;
+	SolverStats stats;
+	conjugateGradient(A, b, x, kMaxIterations, workspace, &stats);
+
+	EXPECT_NEAR(0.0, x(0), 1e-300);
+	EXPECT_NEAR(0.0, x(1), 1e-300);
+	expectConverged(A, b, x, stats, epsilon);
+	EXPECT_NEAR(relativeResidual(A, b, x), stats.residual, 1e-10);
+}
+
+/*
+ * Teste la convergence du gradient conjugué préconditionné, pour les deux
+ * préconditionneurs
+ */
+TEST(TestSolvers, PreconditionedConjugateGradient_Converges)
+{
+	const auto A = createChainMatrix(kBlockRows);
+	const auto b = createRightHandSide(A.rows());
+
+	for (auto type : { kJacobiPreconditioner, kBlockJacobiPreconditioner })
+	{
+		Vector<double, Dynamic> x;
+		SolverWorkspace workspace;
+		SolverStats stats;
+		preconditionedConjugateGradient(A, b, x, kMaxIterations, type, workspace, &stats);
+
+		expectConverged(A, b, x, stats, epsilon);
+	}
+}
+
+/*
+ * Teste que les gradients conjugués retournent une solution nulle, sans NaN,
+ * lorsque b est nul
+ */
+TEST(TestSolvers, ConjugateGradient_ZeroRightHandSide_Ok)
+{
+	const auto A = createChainMatrix(kBlockRows);
+	Vector<double, Dynamic> b(A.rows());
+	b.setZero();
+
+	SolverWorkspace workspace;
+	SolverStats stats;
+	Vector<double, Dynamic> x = createRightHandSide(A.rows());
+	conjugateGradient(A, b, x, kMaxIterations, workspace, &stats);
+	EXPECT_EQ(0, stats.iterations);
+	EXPECT_EQ(0.0, stats.residual);
+	EXPECT_EQ(0.0, x.norm());
+
+	x = createRightHandSide(A.rows());
+	preconditionedConjugateGradient(A, b, x, kMaxIterations, kBlockJacobiPreconditioner, workspace, &stats);
+	EXPECT_EQ(0, stats.iterations);
+	EXPECT_EQ(0.0, stats.residual);
+	EXPECT_EQ(0.0, x.norm());
+}
+
+/*
+ * Teste la convergence de Gauss-Seidel, dans l'ordre des lignes et par
+ * couleurs
+ */
+TEST(TestSolvers, GaussSeidel_Converges)
+{
+	const auto A = createChainMatrix(kBlockRows);
+	const auto b = createRightHandSide(A.rows());
+
+	Vector<double, Dynamic> x;
+	SolverWorkspace workspace;
+	SolverStats stats;
+	gaussSeidel(A, b, x, kMaxIterations, workspace, &stats);
+	expectConverged(A, b, x, stats, 1e-3);
+
+	// Les particules paires puis impaires : deux voisines de la chaîne n'ont
+	// jamais la même couleur
+	std::vector<int> colorBlockRows;
+	for (auto parity = 0; parity < 2; ++parity)
+	{
+		for (auto i = parity; i < kBlockRows; i += 2)
+		{
+			colorBlockRows.push_back(i);
+		}
+	}
+	const std::vector<int> colorPointers = { 0, (kBlockRows + 1) / 2, kBlockRows };
+
+	Vector<double, Dynamic> coloredX;
+	gaussSeidel(A, b, coloredX, kMaxIterations, colorPointers, colorBlockRows, workspace, &stats);
+	expectConverged(A, b, coloredX, stats, 1e-3);
+}
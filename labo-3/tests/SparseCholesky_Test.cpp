@@ -0,0 +1,173 @@
+/**
+ * @file SparseCholesky_Test.cpp
+ *
+ * @brief Unit tests for the SparseCholesky and CachedCholesky classes.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "../Solvers.hpp"
+#include "../SparseCholesky.hpp"
+#include "TestSystems.h"
+
+using namespace gti320;
+
+/*
+ * Résout le système avec la factorisation de Cholesky dense, qui sert de
+ * référence
+ */
+static Vector<double, Dynamic> denseSolve(const BlockSparseMatrix<double>& A, const Vector<double, Dynamic>& b)
+{
+	Vector<double, Dynamic> x;
+	cholesky(A.toDense(), b, x);
+	return x;
+}
+
+/*
+ * Teste que la factorisation creuse donne la même solution que la
+ * factorisation dense
+ */
+TEST(TestSparseCholesky, Solve_MatchesDense_Ok)
+{
+	const auto A = createChainMatrix(6);
+	const auto b = createRightHandSide(A.rows());
+	const auto expected = denseSolve(A, b);
+
+	SparseCholesky factorization;
+	ASSERT_TRUE(factorization.compute(A));
+	EXPECT_TRUE(factorization.isAnalyzedFor(A));
+	EXPECT_GT(factorization.nonZeros(), 0);
+
+	Vector<double, Dynamic> x;
+	factorization.solve(b, x);
+	ASSERT_EQ(A.rows(), x.size());
+	for (auto i = 0; i < x.size(); ++i)
+	{
+		EXPECT_NEAR(expected(i), x(i), 1e-12);
+	}
+	EXPECT_LT(relativeResidual(A, b, x), 1e-12);
+
+	// Même résultat par la fonction du solveur
+	Vector<double, Dynamic> y;
+	SparseCholesky other;
+	ASSERT_TRUE(cholesky(A, b, y, other));
+	for (auto i = 0; i < y.size(); ++i)
+	{
+		EXPECT_DOUBLE_EQ(x(i), y(i));
+	}
+}
+
+/*
+ * Teste qu'une matrice qui n'est pas définie positive est refusée
+ */
+TEST(TestSparseCholesky, NotPositiveDefinite_Fails)
+{
+	auto A = createChainMatrix(4);
+	A.block(A.diagonalBlock(2))[3] = -1.0;
+	const auto b = createRightHandSide(A.rows());
+
+	SparseCholesky factorization;
+	EXPECT_FALSE(factorization.compute(A));
+
+	Vector<double, Dynamic> x;
+	SparseCholesky other;
+	EXPECT_FALSE(cholesky(A, b, x, other));
+
+	CachedCholesky cached;
+	EXPECT_FALSE(cached.solve(A, b, x));
+}
+
+/*
+ * Teste que le facteur est réutilisé, puis refait après le nombre maximal de
+ * résolutions
+ */
+TEST(TestCachedCholesky, RefactorInterval_Ok)
+{
+	const auto A = createChainMatrix(5);
+	const auto b = createRightHandSide(A.rows());
+	const auto expected = denseSolve(A, b);
+
+	CachedCholesky cached(3, 0.05, 2);
+	const bool expectedRefactored[] = { true, false, false, true, false, false, true };
+
+	Vector<double, Dynamic> x;
+	for (auto solve = 0; solve < 7; ++solve)
+	{
+		ASSERT_TRUE(cached.solve(A, b, x));
+		EXPECT_EQ(expectedRefactored[solve], cached.lastSolveRefactored()) << "solve " << solve;
+		for (auto i = 0; i < x.size(); ++i)
+		{
+			EXPECT_NEAR(expected(i), x(i), 1e-12);
+		}
+	}
+
+	cached.invalidate();
+	ASSERT_TRUE(cached.solve(A, b, x));
+	EXPECT_TRUE(cached.lastSolveRefactored());
+}
+
+/*
+ * Teste qu'une petite variation de A réutilise le facteur (avec raffinement)
+ * et qu'une variation au-delà du seuil force une nouvelle factorisation
+ */
+TEST(TestCachedCholesky, ChangeThreshold_Ok)
+{
+	auto A = createChainMatrix(5);
+	const auto b = createRightHandSide(A.rows());
+
+	CachedCholesky cached(100, 0.05, 2);
+	Vector<double, Dynamic> x;
+	ASSERT_TRUE(cached.solve(A, b, x));
+	EXPECT_TRUE(cached.lastSolveRefactored());
+
+	// Variation de 0.01, sous le seuil 0.05 * sqrt(A(i, i) A(j, j))
+	A.block(A.findBlock(1, 2))[0] += 0.01;
+	A.block(A.findBlock(2, 1))[0] += 0.01;
+	ASSERT_TRUE(cached.solve(A, b, x));
+	EXPECT_FALSE(cached.lastSolveRefactored());
+
+	// Le raffinement itératif corrige la solution obtenue avec l'ancien facteur
+	const auto expected = denseSolve(A, b);
+	for (auto i = 0; i < x.size(); ++i)
+	{
+		EXPECT_NEAR(expected(i), x(i), 1e-6);
+	}
+
+	// Variation de 1.0, au-delà du seuil
+	A.block(A.diagonalBlock(3))[0] += 1.0;
+	ASSERT_TRUE(cached.solve(A, b, x));
+	EXPECT_TRUE(cached.lastSolveRefactored());
+
+	const auto refactoredExpected = denseSolve(A, b);
+	for (auto i = 0; i < x.size(); ++i)
+	{
+		EXPECT_NEAR(refactoredExpected(i), x(i), 1e-12);
+	}
+}
+
+/*
+ * Teste les statistiques de la fonction du solveur
+ */
+TEST(TestCachedCholesky, SolverStats_Ok)
+{
+	const auto A = createChainMatrix(5);
+	const auto b = createRightHandSide(A.rows());
+
+	CachedCholesky cached(10, 0.05, 2);
+	Vector<double, Dynamic> x;
+	SolverStats stats;
+
+	ASSERT_TRUE(cholesky(A, b, x, cached, &stats));
+	EXPECT_TRUE(stats.refactored);
+	EXPECT_EQ(0, stats.iterations);
+	EXPECT_LT(stats.residual, 1e-12);
+
+	ASSERT_TRUE(cholesky(A, b, x, cached, &stats));
+	EXPECT_FALSE(stats.refactored);
+	EXPECT_EQ(2, stats.iterations);
+	EXPECT_LT(stats.residual, 1e-12);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+/**
+ * @file TestSystems.h
+ *
+ * @brief Petits systèmes linéaires utilisés par les tests des solveurs.
+ *
+ * Nom: William Lebel
+ * Email : william.lebel.1@ens.etsmtl.ca
+ *
+ */
+
+#include "BlockSparseMatrix.h"
+#include "Vector.h"
+
+#include <utility>
+#include <vector>
+
+namespace gti320
+{
+	/**
+	 * Construit une matrice creuse par blocs symétrique définie positive
+	 * (diagonale strictement dominante) : une chaîne de `blockRows` particules
+	 * dont chacune est couplée à ses deux voisines, comme la matrice
+	 * M - dt^2 df/dx d'une corde.
+	 */
+	inline BlockSparseMatrix<double> createChainMatrix(int blockRows)
+	{
+		std::vector<std::pair<int, int>> blocks;
+		for (auto i = 0; i + 1 < blockRows; ++i)
+		{
+			blocks.emplace_back(i, i + 1);
+			blocks.emplace_back(i + 1, i);
+		}
+
+		BlockSparseMatrix<double> A;
+		A.setPattern(blockRows, blocks);
+
+		const double diagonal[4] = { 4.0, 0.5, 0.5, 3.5 };
+		const double coupling[4] = { -1.0, 0.3, -0.2, -0.8 };
+		for (auto i = 0; i < blockRows; ++i)
+		{
+			double* block = A.block(A.diagonalBlock(i));
+			for (auto k = 0; k < 4; ++k)
+			{
+				block[k] = diagonal[k] + 0.1 * i;
+			}
+			block[1] = block[2] = diagonal[1];
+
+			if (i + 1 < blockRows)
+			{
+				// Le bloc (i + 1, i) est la transposée du bloc (i, i + 1)
+				double* upper = A.block(A.findBlock(i, i + 1));
+				double* lower = A.block(A.findBlock(i + 1, i));
+				upper[0] = lower[0] = coupling[0];
+				upper[1] = lower[2] = coupling[1];
+				upper[2] = lower[1] = coupling[2];
+				upper[3] = lower[3] = coupling[3];
+			}
+		}
+
+		return A;
+	}
+
+	/**
+	 * Construit un second membre non nul de taille `size`
+	 */
+	inline Vector<double, Dynamic> createRightHandSide(int size)
+	{
+		Vector<double, Dynamic> b(size);
+		for (auto i = 0; i < size; ++i)
+		{
+			b(i) = 1.0 + 0.5 * i - 0.25 * (i % 3);
+		}
+		return b;
+	}
+}